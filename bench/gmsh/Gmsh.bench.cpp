@@ -0,0 +1,153 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../../src/gmsh/Gmsh.hpp"
+#include "../../src/logger/Logger.hpp"
+
+/**
+ * Read section
+ * @param file File
+ * @param name Section name
+ * @return Section lines, without the header count
+ */
+std::vector<std::string> readSection(std::ifstream &file,
+                                     const std::string &name) {
+  std::string line;
+  while (std::getline(file, line) && line != name)
+    ;
+
+  std::getline(file, line); // Count
+
+  std::vector<std::string> lines;
+  while (std::getline(file, line) && line.rfind("$End", 0) != 0)
+    lines.push_back(line);
+
+  return lines;
+}
+
+/**
+ * Scale mesh
+ * Writes copies of the source mesh, side by side along x, until the number of
+ * elements is reached
+ * @param source Source mesh (MSH 2.2 ASCII)
+ * @param target Target mesh
+ * @param numberOfElements Minimum number of elements
+ * @return Number of elements written
+ */
+size_t scaleMesh(const std::string &source, const std::string &target,
+                 const size_t numberOfElements) {
+  std::ifstream in(source);
+  const std::vector<std::string> nodes = readSection(in, "$Nodes");
+  const std::vector<std::string> elements = readSection(in, "$Elements");
+  if (nodes.empty() || elements.empty())
+    return 0;
+
+  const size_t copies =
+      (numberOfElements + elements.size() - 1) / elements.size();
+
+  std::ofstream out(target);
+  out << "$MeshFormat\n2.2 0 8\n$EndMeshFormat\n";
+
+  // Nodes
+  out << "$Nodes\n" << copies * nodes.size() << "\n";
+  for (size_t k = 0; k < copies; ++k)
+    for (const std::string &line : nodes) {
+      std::istringstream stream(line);
+      size_t tag;
+      double x;
+      double y;
+      double z;
+      stream >> tag >> x >> y >> z;
+
+      char buffer[128];
+      std::snprintf(buffer, sizeof(buffer), "%zu %.16g %.16g %.16g\n",
+                    tag + k * nodes.size(), x + (double)k, y, z);
+      out << buffer;
+    }
+  out << "$EndNodes\n";
+
+  // Elements
+  out << "$Elements\n" << copies * elements.size() << "\n";
+  for (size_t k = 0; k < copies; ++k)
+    for (const std::string &line : elements) {
+      std::istringstream stream(line);
+      size_t tag;
+      size_t type;
+      size_t numberOfTags;
+      stream >> tag >> type >> numberOfTags;
+      out << tag + k * elements.size() << " " << type << " " << numberOfTags;
+
+      for (size_t j = 0; j < numberOfTags; ++j) {
+        size_t value;
+        stream >> value;
+        out << " " << value;
+      }
+
+      size_t index;
+      while (stream >> index)
+        out << " " << index + k * nodes.size();
+      out << "\n";
+    }
+  out << "$EndElements\n";
+
+  return copies * elements.size();
+}
+
+/**
+ * Gmsh load benchmark
+ * @param argc
+ * @param argv [numberOfElements] [runs]
+ * @return int
+ */
+int main(int argc, const char *argv[]) {
+  const std::string source = "../test/assets/Cube.msh";
+  const std::string target = "Cube.bench.msh";
+  const size_t numberOfElements = argc > 1 ? std::stoul(argv[1]) : 10000000;
+  const int runs = argc > 2 ? std::stoi(argv[2]) : 3;
+
+  // Mesh
+  const size_t written = scaleMesh(source, target, numberOfElements);
+  if (!written) {
+    Logger::ERROR("Unable to scale " + source);
+    return EXIT_FAILURE;
+  }
+
+  std::ifstream sizeFile(target, std::ios::binary | std::ios::ate);
+  const auto bytes = (double)sizeFile.tellg();
+
+  // Runs
+  double best = 0;
+  for (int run = 0; run < runs; ++run) {
+    auto gmsh = Gmsh();
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool res = gmsh.load(target);
+    const auto end = std::chrono::steady_clock::now();
+
+    if (!res) {
+      Logger::ERROR("Unable to load " + target);
+      std::remove(target.c_str());
+      return EXIT_FAILURE;
+    }
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    if (!run || seconds < best)
+      best = seconds;
+  }
+
+  std::remove(target.c_str());
+
+  Logger::LOG("Gmsh::load, " + std::to_string(written) + " elements, " +
+              std::to_string(bytes / 1.e6) + " MB");
+  Logger::LOG("  best of " + std::to_string(runs) + ": " +
+              std::to_string(best) + " s, " +
+              std::to_string(bytes / 1.e6 / best) + " MB/s, " +
+              std::to_string((double)written / 1.e6 / best) +
+              " M elements/s");
+
+  return EXIT_SUCCESS;
+}
@@ -10,8 +10,30 @@
 
 #include <tiny_gltf.h>
 
-void writeSurface(const Surface &, tinygltf::Model &,
-                  std::vector<tinygltf::Value> &, const uint);
+/**
+ * Encoded surface
+ * Buffer and accessor bounds, ready to be appended to the model
+ */
+struct EncodedSurface {
+  uint label = 0;
+  size_t numberOfIndices = 0;
+  size_t numberOfVertices = 0;
+  size_t paddingLength = 0;
+  uint minIndex = 0;
+  uint maxIndex = 0;
+  Vertex minVertex;
+  Vertex maxVertex;
+  tinygltf::Buffer buffer;
+};
+
+EncodedSurface encodeSurface(const Surface &);
+void writeSurface(EncodedSurface &, tinygltf::Model &,
+                  std::vector<tinygltf::Value> &, const std::string &);
+int writeVertices(const std::vector<Vertex> &, tinygltf::Model &);
+void writeSharedSurface(const Surface &, const int, tinygltf::Model &,
+                        std::vector<tinygltf::Value> &, const std::string &);
+void writeMesh(const uint, const int, const int, tinygltf::Model &,
+               std::vector<tinygltf::Value> &, const std::string &);
 std::vector<double> generateColor();
 
 /**
@@ -28,15 +50,27 @@ int main(int argc, const char *argv[]) {
   // Arguments
   if (argc < 3) {
     Logger::ERROR("USAGE:");
-    Logger::ERROR("GmshToGLTF meshFile gltfFile");
+    Logger::ERROR(
+        "GmshToGLTF meshFile gltfFile [--shared] [physicalGroup ...]");
+    Logger::ERROR("  --shared: one vertex buffer for all faces and solids");
     return EXIT_FAILURE;
   }
   meshFile = argv[1];
   gltfFile = argv[2];
 
+  // Options, then physical groups (tags or names), all when empty
+  bool shared = false;
+  std::vector<std::string> groups;
+  for (int i = 3; i < argc; ++i) {
+    if (std::string(argv[i]) == "--shared")
+      shared = true;
+    else
+      groups.push_back(argv[i]);
+  }
+
   // Read & process mesh
   auto gmsh = std::make_unique<Gmsh>();
-  res = gmsh->load(meshFile);
+  res = gmsh->load(meshFile, groups);
   if (!res) {
     Logger::ERROR("Unable to load Gmsh file " + meshFile);
     return EXIT_FAILURE;
@@ -47,18 +81,73 @@ int main(int argc, const char *argv[]) {
   tinygltf::Scene scene;
   tinygltf::Asset asset;
 
-  // Surface
   std::vector<tinygltf::Value> facesExtras;
-  std::vector<uint> surfaceLabels = gmsh->getSurfaceLabels();
-  std::for_each(surfaceLabels.begin(), surfaceLabels.end(),
-                [&gmsh, &model, &scene, &facesExtras](const uint label) {
-                  Surface surface = gmsh->getSurface(label);
-
-                  writeSurface(surface, model, facesExtras, label);
-
-                  // Scene
-                  scene.nodes.push_back((int)model.nodes.size() - 1);
-                });
+  std::vector<tinygltf::Value> solidsExtras;
+  Partition partition = gmsh->partitionTriangles();
+  Partition volumesPartition = gmsh->partitionTetrahedra();
+  IndexMap indices;
+
+  if (shared) {
+    // Surfaces & volume skins, indexed in one vertex array
+    std::vector<Vertex> vertices;
+    std::vector<Surface> surfaces;
+    std::vector<Surface> skins;
+    for (uint bucket = 0; bucket < partition.labels.size(); ++bucket)
+      surfaces.push_back(
+          gmsh->getSurface(partition, bucket, indices, vertices));
+    for (uint bucket = 0; bucket < volumesPartition.labels.size(); ++bucket)
+      skins.push_back(
+          gmsh->getSkin(volumesPartition, bucket, indices, vertices));
+
+    const int position = writeVertices(vertices, model);
+
+    for (uint i = 0; i < surfaces.size(); ++i) {
+      writeSharedSurface(surfaces.at(i), position, model, facesExtras,
+                         "Face " + std::to_string(i + 1));
+
+      // Scene
+      scene.nodes.push_back((int)model.nodes.size() - 1);
+    }
+
+    for (uint i = 0; i < skins.size(); ++i) {
+      writeSharedSurface(skins.at(i), position, model, solidsExtras,
+                         "Solid " + std::to_string(i + 1));
+
+      // Scene
+      scene.nodes.push_back((int)model.nodes.size() - 1);
+    }
+  } else {
+    // Surfaces, extracted and encoded in parallel
+    std::vector<EncodedSurface> surfaces(partition.labels.size());
+    Utils::parallelFor(
+        surfaces.size(), [&gmsh, &partition, &surfaces](const size_t bucket) {
+          // One index map per thread, cleared by getSurface
+          static thread_local IndexMap threadIndices;
+          surfaces.at(bucket) = encodeSurface(
+              gmsh->getSurface(partition, (uint)bucket, threadIndices));
+        });
+
+    // Appended in label order
+    for (uint bucket = 0; bucket < surfaces.size(); ++bucket) {
+      writeSurface(surfaces.at(bucket), model, facesExtras,
+                   "Face " + std::to_string(bucket + 1));
+
+      // Scene
+      scene.nodes.push_back((int)model.nodes.size() - 1);
+    }
+
+    // Volume skins, already computed in parallel
+    for (uint bucket = 0; bucket < volumesPartition.labels.size(); ++bucket) {
+      EncodedSurface skin =
+          encodeSurface(gmsh->getSkin(volumesPartition, bucket, indices));
+
+      writeSurface(skin, model, solidsExtras,
+                   "Solid " + std::to_string(bucket + 1));
+
+      // Scene
+      scene.nodes.push_back((int)model.nodes.size() - 1);
+    }
+  }
 
   // Scene
   scene.name = "master";
@@ -66,6 +155,7 @@ int main(int argc, const char *argv[]) {
       tinygltf::Value({{"type", tinygltf::Value(std::string("mesh"))},
                        {"uuid", tinygltf::Value(Utils::uuid())},
                        {"dimension", tinygltf::Value(3)},
+                       {"solids", tinygltf::Value(solidsExtras)},
                        {"faces", tinygltf::Value(facesExtras)}});
 
   // Scenes
@@ -92,22 +182,24 @@ int main(int argc, const char *argv[]) {
 }
 
 /**
- * Write surface
+ * Encode surface
+ * Independent of the model, may run in parallel
  * @param surface Surface
- * @param model Model
- * @param facesExtras Faces extras
+ * @return Encoded surface
  */
-void writeSurface(const Surface &surface, tinygltf::Model &model,
-                  std::vector<tinygltf::Value> &facesExtras, const uint label) {
-  tinygltf::Node node;
-  tinygltf::Mesh mesh;
-  tinygltf::Buffer buffer;
-  tinygltf::BufferView bufferViewIndices;
-  tinygltf::BufferView bufferViewVertices;
-  tinygltf::Accessor accessorIndices;
-  tinygltf::Accessor accessorVertices;
-  tinygltf::Primitive primitive;
-  tinygltf::Material material;
+EncodedSurface encodeSurface(const Surface &surface) {
+  EncodedSurface encoded;
+  encoded.label = surface.label;
+  encoded.numberOfIndices = surface.triangles.size() * 3;
+  encoded.numberOfVertices = surface.vertices.size();
+  encoded.minIndex = surface.minIndex;
+  encoded.maxIndex = surface.maxIndex;
+  encoded.minVertex = surface.minVertex;
+  encoded.maxVertex = surface.maxVertex;
+
+  tinygltf::Buffer &buffer = encoded.buffer;
+  buffer.data.reserve(encoded.numberOfIndices * __SIZEOF_INT__ +
+                      encoded.numberOfVertices * 3 * __SIZEOF_FLOAT__ + 4);
 
   // Indices
   std::for_each(surface.triangles.begin(), surface.triangles.end(),
@@ -123,8 +215,8 @@ void writeSurface(const Surface &surface, tinygltf::Model &model,
                 });
 
   // Padding
-  size_t paddingLength = buffer.data.size() % 4;
-  for (size_t padding = 0; padding < paddingLength; ++padding) {
+  encoded.paddingLength = buffer.data.size() % 4;
+  for (size_t padding = 0; padding < encoded.paddingLength; ++padding) {
     buffer.data.push_back(0x00);
   }
 
@@ -140,20 +232,39 @@ void writeSurface(const Surface &surface, tinygltf::Model &model,
                   Utils::floatToBuffer((float)y, buffer.data);
                   Utils::floatToBuffer((float)z, buffer.data);
                 });
-  model.buffers.push_back(buffer);
+
+  return encoded;
+}
+
+/**
+ * Write surface
+ * @param surface Encoded surface, its buffer is moved to the model
+ * @param model Model
+ * @param facesExtras Faces (or solids) extras
+ * @param name Mesh name
+ */
+void writeSurface(EncodedSurface &surface, tinygltf::Model &model,
+                  std::vector<tinygltf::Value> &facesExtras,
+                  const std::string &name) {
+  tinygltf::BufferView bufferViewIndices;
+  tinygltf::BufferView bufferViewVertices;
+  tinygltf::Accessor accessorIndices;
+  tinygltf::Accessor accessorVertices;
+
+  model.buffers.push_back(std::move(surface.buffer));
 
   // Buffer views
   bufferViewIndices.buffer = (int)model.buffers.size() - 1;
   bufferViewIndices.byteOffset = 0;
-  bufferViewIndices.byteLength = surface.triangles.size() * 3 * __SIZEOF_INT__;
+  bufferViewIndices.byteLength = surface.numberOfIndices * __SIZEOF_INT__;
   bufferViewIndices.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
   model.bufferViews.push_back(bufferViewIndices);
 
   bufferViewVertices.buffer = (int)model.buffers.size() - 1;
   bufferViewVertices.byteOffset =
-      surface.triangles.size() * 3 * __SIZEOF_INT__ + paddingLength;
+      surface.numberOfIndices * __SIZEOF_INT__ + surface.paddingLength;
   bufferViewVertices.byteLength =
-      surface.vertices.size() * 3 * __SIZEOF_FLOAT__;
+      surface.numberOfVertices * 3 * __SIZEOF_FLOAT__;
   bufferViewVertices.target = TINYGLTF_TARGET_ARRAY_BUFFER;
   model.bufferViews.push_back(bufferViewVertices);
 
@@ -161,7 +272,7 @@ void writeSurface(const Surface &surface, tinygltf::Model &model,
   accessorIndices.bufferView = (int)model.bufferViews.size() - 2;
   accessorIndices.byteOffset = 0;
   accessorIndices.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
-  accessorIndices.count = surface.triangles.size() * 3;
+  accessorIndices.count = surface.numberOfIndices;
   accessorIndices.type = TINYGLTF_TYPE_SCALAR;
   accessorIndices.minValues.push_back(surface.minIndex);
   accessorIndices.maxValues.push_back(surface.maxIndex);
@@ -170,7 +281,7 @@ void writeSurface(const Surface &surface, tinygltf::Model &model,
   accessorVertices.bufferView = (int)model.bufferViews.size() - 1;
   accessorVertices.byteOffset = 0;
   accessorVertices.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-  accessorVertices.count = surface.vertices.size();
+  accessorVertices.count = surface.numberOfVertices;
   accessorVertices.type = TINYGLTF_TYPE_VEC3;
   accessorVertices.minValues = {surface.minVertex.X(), surface.minVertex.Y(),
                                 surface.minVertex.Z()};
@@ -178,6 +289,127 @@ void writeSurface(const Surface &surface, tinygltf::Model &model,
                                 surface.maxVertex.Z()};
   model.accessors.push_back(accessorVertices);
 
+  writeMesh(surface.label, (int)model.accessors.size() - 2,
+            (int)model.accessors.size() - 1, model, facesExtras, name);
+}
+
+/**
+ * Write vertices
+ * Shared vertex buffer, indices are appended to it later on
+ * @param vertices Vertices
+ * @param model Model
+ * @return POSITION accessor
+ */
+int writeVertices(const std::vector<Vertex> &vertices,
+                  tinygltf::Model &model) {
+  tinygltf::Buffer buffer;
+  tinygltf::BufferView bufferViewVertices;
+  tinygltf::Accessor accessorVertices;
+
+  // Vertices
+  buffer.data.reserve(vertices.size() * 3 * __SIZEOF_FLOAT__);
+  std::for_each(vertices.begin(), vertices.end(),
+                [&buffer](const Vertex &vertex) {
+                  // To buffer
+                  Utils::floatToBuffer((float)vertex.X(), buffer.data);
+                  Utils::floatToBuffer((float)vertex.Y(), buffer.data);
+                  Utils::floatToBuffer((float)vertex.Z(), buffer.data);
+                });
+  model.buffers.push_back(buffer);
+
+  // Buffer view
+  bufferViewVertices.buffer = (int)model.buffers.size() - 1;
+  bufferViewVertices.byteOffset = 0;
+  bufferViewVertices.byteLength = vertices.size() * 3 * __SIZEOF_FLOAT__;
+  bufferViewVertices.target = TINYGLTF_TARGET_ARRAY_BUFFER;
+  model.bufferViews.push_back(bufferViewVertices);
+
+  // Accessor
+  std::vector<Vertex> minMax = Utils::minMax(vertices);
+  accessorVertices.bufferView = (int)model.bufferViews.size() - 1;
+  accessorVertices.byteOffset = 0;
+  accessorVertices.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
+  accessorVertices.count = vertices.size();
+  accessorVertices.type = TINYGLTF_TYPE_VEC3;
+  accessorVertices.minValues = {minMax.at(0).X(), minMax.at(0).Y(),
+                                minMax.at(0).Z()};
+  accessorVertices.maxValues = {minMax.at(1).X(), minMax.at(1).Y(),
+                                minMax.at(1).Z()};
+  model.accessors.push_back(accessorVertices);
+
+  return (int)model.accessors.size() - 1;
+}
+
+/**
+ * Write shared surface
+ * Indices are appended to the shared vertex buffer
+ * @param surface Surface, indexed in the shared vertices
+ * @param position POSITION accessor
+ * @param model Model
+ * @param facesExtras Faces (or solids) extras
+ * @param name Mesh name
+ */
+void writeSharedSurface(const Surface &surface, const int position,
+                        tinygltf::Model &model,
+                        std::vector<tinygltf::Value> &facesExtras,
+                        const std::string &name) {
+  tinygltf::BufferView bufferViewIndices;
+  tinygltf::Accessor accessorIndices;
+
+  const int bufferIndex =
+      model.bufferViews.at(model.accessors.at(position).bufferView).buffer;
+  tinygltf::Buffer &buffer = model.buffers.at(bufferIndex);
+  const size_t byteOffset = buffer.data.size();
+
+  // Indices
+  std::for_each(surface.triangles.begin(), surface.triangles.end(),
+                [&buffer](const Triangle triangle) {
+                  // To buffer
+                  Utils::uintToBuffer(triangle.I1(), buffer.data);
+                  Utils::uintToBuffer(triangle.I2(), buffer.data);
+                  Utils::uintToBuffer(triangle.I3(), buffer.data);
+                });
+
+  // Buffer view
+  bufferViewIndices.buffer = bufferIndex;
+  bufferViewIndices.byteOffset = byteOffset;
+  bufferViewIndices.byteLength = surface.triangles.size() * 3 * __SIZEOF_INT__;
+  bufferViewIndices.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
+  model.bufferViews.push_back(bufferViewIndices);
+
+  // Accessor
+  accessorIndices.bufferView = (int)model.bufferViews.size() - 1;
+  accessorIndices.byteOffset = 0;
+  accessorIndices.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+  accessorIndices.count = surface.triangles.size() * 3;
+  accessorIndices.type = TINYGLTF_TYPE_SCALAR;
+  accessorIndices.minValues.push_back(surface.minIndex);
+  accessorIndices.maxValues.push_back(surface.maxIndex);
+  model.accessors.push_back(accessorIndices);
+
+  writeMesh(surface.label, (int)model.accessors.size() - 1, position, model,
+            facesExtras, name);
+}
+
+/**
+ * Write mesh
+ * Material, primitive, mesh, extras and node
+ * @param label Label
+ * @param indices Indices accessor
+ * @param position POSITION accessor
+ * @param model Model
+ * @param facesExtras Faces (or solids) extras
+ * @param name Mesh name
+ */
+void writeMesh(const uint label, const int indices, const int position,
+               tinygltf::Model &model,
+               std::vector<tinygltf::Value> &facesExtras,
+               const std::string &name) {
+  tinygltf::Node node;
+  tinygltf::Mesh mesh;
+  tinygltf::Primitive primitive;
+  tinygltf::Material material;
+
   // Material
   std::vector<double> color = generateColor();
   material.pbrMetallicRoughness.baseColorFactor = color;
@@ -185,13 +417,13 @@ void writeSurface(const Surface &surface, tinygltf::Model &model,
   model.materials.push_back(material);
 
   // Primitive
-  primitive.indices = (int)model.accessors.size() - 2;
-  primitive.attributes["POSITION"] = (int)model.accessors.size() - 1;
+  primitive.indices = indices;
+  primitive.attributes["POSITION"] = position;
   primitive.material = (int)model.materials.size() - 1;
   primitive.mode = TINYGLTF_MODE_TRIANGLES;
 
   // Mesh
-  mesh.name = "Face " + std::to_string(model.meshes.size() + 1);
+  mesh.name = name;
   std::string uuid = Utils::uuid();
   mesh.extras = tinygltf::Value({{"uuid", tinygltf::Value(uuid)},
                                  {"label", tinygltf::Value((int)label)}});
@@ -1,8 +1,12 @@
 #include <algorithm>
+#include <cstdlib>
+#include <mutex>
 
 #include "logger/Logger.hpp"
 #include "occ/Triangulation.hpp"
+#include "utils/fields.hpp"
 #include "utils/utils.hpp"
+#include "vtk/PVDReader.hpp"
 #include "vtk/VTUReader.hpp"
 
 #define TINYGLTF_IMPLEMENTATION
@@ -11,11 +15,72 @@
 
 #include <tiny_gltf.h>
 
-bool writeScalar(const std::string &, const Result &);
-bool writeVector(const std::string &, const Result &);
+/**
+ * Model of results sharing the same geometry, fields as _DATA_<name>
+ * attributes
+ */
+struct ResultModel {
+  // Quantize the positions, values & indices
+  bool quantize = false;
+  tinygltf::Model model;
+  tinygltf::Scene scene;
+  tinygltf::Value::Object extras;
+  // Fields names
+  std::vector<std::string> names;
+  // Fields accessors, on polygons (-1 without polygons) & triangles
+  std::vector<int> polygonsAccessors;
+  std::vector<int> trianglesAccessors;
+  // Fields ranges, if quantized
+  std::vector<tinygltf::Value> ranges;
+};
+
+/**
+ * Field job, one glb per scalar, vector magnitude or vector component
+ */
+struct FieldJob {
+  const Result *result;
+  // Component index, -1 for a scalar, 3 for the magnitude
+  int component;
+  std::string gltfFile;
+};
+
+std::vector<FieldJob> getFieldJobs(const std::vector<Result> &,
+                                   const std::string &);
+size_t writeMemory(const Result &);
+bool writeFields(const std::vector<Result> &, const std::string &, const bool,
+                 const size_t, const size_t);
 Result getMagnitude(const Result &);
 Result getComponent(const Result &, const int);
-bool writeOne(const Result &, const std::string &);
+bool writeOne(const Result &, const std::string &, const bool);
+bool writeAll(const std::vector<Result> &, const bool, const std::string &);
+bool writeSteps(const std::vector<PVDDataSet> &, const bool,
+                const CellDataMode, const bool, const bool,
+                const std::string &);
+bool appendFields(const std::vector<Result> &, ResultModel &,
+                  std::vector<int> &, std::vector<int> &,
+                  std::vector<tinygltf::Value> &);
+bool buildModel(const std::vector<Result> &, ResultModel &);
+bool writeModel(ResultModel &, const std::string &);
+void addTrianglesPrimitives(const ResultGeometry &, const tinygltf::Primitive &,
+                            tinygltf::Model &, tinygltf::Mesh &);
+void addPolylinesPrimitives(const ResultGeometry &, const bool,
+                            const tinygltf::Primitive &, tinygltf::Model &,
+                            tinygltf::Mesh &);
+int appendBufferView(const std::vector<unsigned char> &, const int,
+                     tinygltf::Model &, const size_t = 0);
+int appendAccessor(const int, const int, const size_t, const int,
+                   const std::vector<double> &, const std::vector<double> &,
+                   tinygltf::Model &);
+int appendIndices(const std::vector<uint> &, const uint, const uint,
+                  const bool, tinygltf::Model &);
+int appendVertices(const std::vector<Vertex> &, const Vertex &, const Vertex &,
+                   const bool, tinygltf::Model &);
+void setDequantization(const Vertex &, const Vertex &, tinygltf::Node &);
+std::vector<std::vector<double>> valuesRange(const Result &);
+tinygltf::Value rangeExtras(const std::vector<std::vector<double>> &);
+int appendValues(const std::vector<float> &, const int,
+                 const std::vector<std::vector<double>> &, const bool,
+                 tinygltf::Model &);
 
 /**
  * VTUToGLTF
@@ -30,14 +95,75 @@ int main(int argc, const char *argv[]) {
 
   if (argc < 3) {
     Logger::ERROR("USAGE:");
-    Logger::ERROR("./VTUToGLTF vtuFile genericGltfFile");
+    Logger::ERROR("./VTUToGLTF vtuFile genericGltfFile [--no-weld] [--single] "
+                  "[--cell-data=average|flat] [--native] [--quantize] "
+                  "[--jobs=n] [--memory=MB]");
+    Logger::ERROR("  vtuFile: .vtu or .pvtu file, or .pvd time steps, "
+                  "written to one glb");
+    Logger::ERROR("  --no-weld: one primitive per piece");
+    Logger::ERROR("  --single: one glb, with one attribute per field");
+    Logger::ERROR("  --cell-data=average: cell data, averaged at the points");
+    Logger::ERROR("  --cell-data=flat: cell data, one value per face");
+    Logger::ERROR("  --native: parse .vtu files without VTK when possible");
+    Logger::ERROR("  --quantize: 16 bits positions & values "
+                  "(KHR_mesh_quantization)");
+    Logger::ERROR("  --jobs=n: fields written concurrently, default: number "
+                  "of threads");
+    Logger::ERROR("  --memory=MB: memory cap of the concurrent writes, "
+                  "default: 1024");
     return EXIT_FAILURE;
   }
   vtuFile = argv[1];
   genericGltfFile = argv[2];
 
+  // Options
+  bool weld = true;
+  bool single = false;
+  CellDataMode cellData = CellDataMode::Ignore;
+  bool native = false;
+  bool quantize = false;
+  size_t numberOfWorkers = Utils::numberOfThreads();
+  size_t memory = 1024;
+  for (int i = 3; i < argc; ++i) {
+    if (std::string(argv[i]) == "--no-weld")
+      weld = false;
+    else if (std::string(argv[i]) == "--single")
+      single = true;
+    else if (std::string(argv[i]) == "--cell-data=average")
+      cellData = CellDataMode::Average;
+    else if (std::string(argv[i]) == "--cell-data=flat")
+      cellData = CellDataMode::Flat;
+    else if (std::string(argv[i]) == "--native")
+      native = true;
+    else if (std::string(argv[i]) == "--quantize")
+      quantize = true;
+    else if (std::string(argv[i]).rfind("--jobs=", 0) == 0)
+      numberOfWorkers = std::strtoul(argv[i] + 7, nullptr, 10);
+    else if (std::string(argv[i]).rfind("--memory=", 0) == 0)
+      memory = std::strtoul(argv[i] + 9, nullptr, 10);
+  }
+
+  // Time steps
+  const std::string extension = ".pvd";
+  if (vtuFile.size() >= extension.size() &&
+      vtuFile.compare(vtuFile.size() - extension.size(), extension.size(),
+                      extension) == 0) {
+    auto collection = PVDReader(vtuFile);
+    if (!collection.read()) {
+      Logger::ERROR("Unable to read PVD file " + vtuFile);
+      return EXIT_FAILURE;
+    }
+    if (!writeSteps(collection.getDataSets(), weld, cellData, native,
+                    quantize, genericGltfFile + ".glb"))
+      return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+  }
+
   // Read VTU file
   auto reader = VTUReader(vtuFile);
+  reader.setWeld(weld);
+  reader.setCellData(cellData);
+  reader.setNative(native);
   res = reader.read();
   if (!res) {
     Logger::ERROR("Unable to read VTU file " + vtuFile);
@@ -46,464 +172,273 @@ int main(int argc, const char *argv[]) {
 
   // Results
   std::vector<Result> results = reader.getResults();
-  bool globalStatus = true;
-  std::for_each(results.begin(), results.end(),
-                [&genericGltfFile, &globalStatus](const Result &result) {
-                  if (result.size == 1) { // Scalar
-                    bool status = writeScalar(genericGltfFile, result);
-                    globalStatus = globalStatus && status;
-                  } else if (result.size == 3) { // Vector
-                    bool status = writeVector(genericGltfFile, result);
-                    globalStatus = globalStatus && status;
-                  }
-                });
-  if (!globalStatus)
+  if (single) {
+    if (!writeAll(results, quantize, genericGltfFile + ".glb"))
+      return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+  }
+
+  if (!writeFields(results, genericGltfFile, quantize, numberOfWorkers,
+                   memory * 1024 * 1024))
     return EXIT_FAILURE;
 
   return EXIT_SUCCESS;
 }
 
 /**
- * Write scalar
+ * Get field jobs
+ * Scalars as is, vectors as magnitude & components, in results order
+ * @param results Results
  * @param genericGltfFile Generic GLTF file
- * @param result Result
- * @return true
- * @return false
+ * @return Field jobs
  */
-bool writeScalar(const std::string &genericGltfFile, const Result &result) {
-  return writeOne(result, genericGltfFile + "_" + result.name + ".glb");
+std::vector<FieldJob> getFieldJobs(const std::vector<Result> &results,
+                                   const std::string &genericGltfFile) {
+  std::vector<FieldJob> jobs;
+  std::for_each(
+      results.begin(), results.end(),
+      [&jobs, &genericGltfFile](const Result &result) {
+        const std::string gltfFile = genericGltfFile + "_" + result.name;
+        if (result.size == 1) { // Scalar
+          jobs.push_back({&result, -1, gltfFile + ".glb"});
+        } else if (result.size == 3) { // Vector
+          jobs.push_back({&result, 3, gltfFile + "_magnitude_line.glb"});
+          for (int j = 0; j < 3; ++j)
+            jobs.push_back({&result, j,
+                            gltfFile + "_component" + std::to_string(j + 1) +
+                                "_line.glb"});
+        }
+      });
+
+  return jobs;
 }
 
 /**
- * Write vector
- * @param genericGltfFile Generic GLTF file
+ * Write memory
+ * Estimated peak memory of one field write: the derived values, the model
+ * buffer and its serialized copy
  * @param result Result
- * @return true
- * @return false
+ * @return Bytes
  */
-bool writeVector(const std::string &genericGltfFile, const Result &result) {
-  // Magnitude
-  Result magnitude = getMagnitude(result);
-  bool status = writeOne(magnitude, genericGltfFile + "_" + result.name +
-                                        "_magnitude_line.glb");
-  if (!status)
-    return status;
-
-  // Component 1, 2 & 3
-  for (int j = 0; j < 3; ++j) {
-    Result component = getComponent(result, j);
-    status =
-        writeOne(component, genericGltfFile + "_" + result.name + "_component" +
-                                std::to_string(j + 1) + "_line.glb");
-
-    if (!status)
-      return status;
-  }
+size_t writeMemory(const Result &result) {
+  const ResultGeometry &geometry = *result.geometry;
+  const size_t numberOfVertices =
+      geometry.polygonsVertices.size() + geometry.trianglesVertices.size();
+  const size_t numberOfIndices =
+      2 * geometry.polygons.getIndices().size() + 3 * geometry.triangles.size();
+
+  // Positions & values as floats, indices as unsigned ints
+  const size_t buffer = numberOfVertices * 4 * __SIZEOF_FLOAT__ +
+                        numberOfIndices * __SIZEOF_INT__;
+  return 3 * buffer;
+}
 
-  return true;
+/**
+ * Write fields
+ * One glb per field job, written by up to numberOfWorkers workers within the
+ * memory cap. The glb lines are displayed in jobs order
+ * @param results Results
+ * @param genericGltfFile Generic GLTF file
+ * @param quantize Quantize the positions, values & indices
+ * @param numberOfWorkers Number of workers
+ * @param memory Memory cap, in bytes
+ * @return Status
+ */
+bool writeFields(const std::vector<Result> &results,
+                 const std::string &genericGltfFile, const bool quantize,
+                 const size_t numberOfWorkers, const size_t memory) {
+  const std::vector<FieldJob> jobs = getFieldJobs(results, genericGltfFile);
+
+  std::vector<std::string> messages(jobs.size());
+  std::vector<char> done(jobs.size(), false);
+  size_t displayed = 0;
+  bool globalStatus = true;
+  std::mutex mutex;
+
+  Utils::parallelFor(
+      jobs.size(), numberOfWorkers, memory,
+      [&jobs](const size_t i) { return writeMemory(*jobs.at(i).result); },
+      [&jobs, quantize, &messages, &done, &displayed, &globalStatus,
+       &mutex](const size_t i) {
+        const FieldJob &job = jobs.at(i);
+
+        // Derived field
+        Result derived;
+        const Result *field = job.result;
+        if (job.component == 3) {
+          derived = getMagnitude(*job.result);
+          field = &derived;
+        } else if (job.component >= 0) {
+          derived = getComponent(*job.result, job.component);
+          field = &derived;
+        }
+
+        const bool status = writeOne(*field, job.gltfFile, quantize);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        globalStatus = globalStatus && status;
+        if (status)
+          messages[i] = R"({ "glb": ")" + job.gltfFile + R"(", "name": ")" +
+                        field->name + R"(" })";
+        done[i] = true;
+
+        // Display, in jobs order
+        for (; displayed < jobs.size() && done[displayed]; ++displayed)
+          if (!messages[displayed].empty())
+            Logger::DISP(messages[displayed]);
+      });
+
+  return globalStatus;
 }
 
 /**
  * Get magnitude
+ * The geometry is shared, not copied
  * @param result Result
  * @return Magnitude
  */
 Result getMagnitude(const Result &result) {
-  Result magnitude = result;
+  Result magnitude;
   magnitude.size = 1;
   magnitude.name = result.name + " (magnitude)";
+  magnitude.geometry = result.geometry;
 
   // Polygons values
-  magnitude.polygonsValues.clear();
-  for (uint i = 0; i < result.polygonsValues.size() / 3; ++i) {
-    auto v = sqrt(pow(result.polygonsValues[3 * i + 0], 2) +
-                  pow(result.polygonsValues[3 * i + 1], 2) +
-                  pow(result.polygonsValues[3 * i + 2], 2));
-    magnitude.polygonsValues.push_back(v);
-  }
-
-  double polygonsMinValue =
-      magnitude.polygonsValues.size() ? magnitude.polygonsValues.at(0) : 0;
-  double polygonsMaxValue =
-      magnitude.polygonsValues.size() ? magnitude.polygonsValues.at(0) : 0;
-  std::for_each(magnitude.polygonsValues.begin(),
-                magnitude.polygonsValues.end(),
-                [&polygonsMinValue, &polygonsMaxValue](const double value) {
-                  polygonsMinValue = std::min(polygonsMinValue, value);
-                  polygonsMaxValue = std::max(polygonsMaxValue, value);
-                });
-
-  magnitude.polygonsMinValue = polygonsMinValue;
-  magnitude.polygonsMaxValue = polygonsMaxValue;
+  std::vector<double> polygonsMinMaxValue =
+      Fields::magnitude(result.polygonsValues.data(),
+                        result.polygonsValues.size() / 3,
+                        magnitude.polygonsValues);
+  magnitude.polygonsMinValue = polygonsMinMaxValue.at(0);
+  magnitude.polygonsMaxValue = polygonsMinMaxValue.at(1);
 
   // Triangles values
-  magnitude.trianglesValues.clear();
-  for (uint i = 0; i < result.trianglesValues.size() / 3; ++i) {
-    auto v = sqrt(pow(result.trianglesValues[3 * i + 0], 2) +
-                  pow(result.trianglesValues[3 * i + 1], 2) +
-                  pow(result.trianglesValues[3 * i + 2], 2));
-    magnitude.trianglesValues.push_back(v);
-  }
-
-  double trianglesMinValue =
-      magnitude.trianglesValues.size() ? magnitude.trianglesValues.at(0) : 0;
-  double trianglesMaxValue =
-      magnitude.trianglesValues.size() ? magnitude.trianglesValues.at(0) : 0;
-  std::for_each(magnitude.trianglesValues.begin(),
-                magnitude.trianglesValues.end(),
-                [&trianglesMinValue, &trianglesMaxValue](const double value) {
-                  trianglesMinValue = std::min(trianglesMinValue, value);
-                  trianglesMaxValue = std::max(trianglesMaxValue, value);
-                });
-
-  magnitude.trianglesMinValue = trianglesMinValue;
-  magnitude.trianglesMaxValue = trianglesMaxValue;
+  std::vector<double> trianglesMinMaxValue =
+      Fields::magnitude(result.trianglesValues.data(),
+                        result.trianglesValues.size() / 3,
+                        magnitude.trianglesValues);
+  magnitude.trianglesMinValue = trianglesMinMaxValue.at(0);
+  magnitude.trianglesMaxValue = trianglesMinMaxValue.at(1);
 
   return magnitude;
 }
 
 /**
  * Get component
+ * The geometry is shared, not copied
  * @param result Result
  * @param index Index
  * @return Component
  */
 Result getComponent(const Result &result, const int index) {
-  Result component = result;
+  Result component;
   component.size = 1;
   component.name =
       result.name + " (component " + std::to_string(index + 1) + ")";
+  component.geometry = result.geometry;
 
   // Polygons values
-  component.polygonsValues.clear();
-  for (uint i = 0; i < result.polygonsValues.size() / 3; ++i) {
-    double v = result.polygonsValues[3 * i + index];
-    component.polygonsValues.push_back(v);
-  }
-
-  double polygonsMinValue =
-      component.polygonsValues.size() ? component.polygonsValues.at(0) : 0;
-  double polygonsMaxValue =
-      component.polygonsValues.size() ? component.polygonsValues.at(0) : 0;
-  std::for_each(component.polygonsValues.begin(),
-                component.polygonsValues.end(),
-                [&polygonsMinValue, &polygonsMaxValue](const double value) {
-                  polygonsMinValue = std::min(polygonsMinValue, value);
-                  polygonsMaxValue = std::max(polygonsMaxValue, value);
-                });
-
-  component.polygonsMinValue = polygonsMinValue;
-  component.polygonsMaxValue = polygonsMaxValue;
+  std::vector<double> polygonsMinMaxValue = Fields::component(
+      result.polygonsValues.data(), result.polygonsValues.size() / 3, 3,
+      index, component.polygonsValues);
+  component.polygonsMinValue = polygonsMinMaxValue.at(0);
+  component.polygonsMaxValue = polygonsMinMaxValue.at(1);
 
   // Triangles values
-  component.trianglesValues.clear();
-  for (uint i = 0; i < result.trianglesValues.size() / 3; ++i) {
-    double v = result.trianglesValues[3 * i + index];
-    component.trianglesValues.push_back(v);
-  }
-
-  double trianglesMinValue =
-      component.trianglesValues.size() ? component.trianglesValues.at(0) : 0;
-  double trianglesMaxValue =
-      component.trianglesValues.size() ? component.trianglesValues.at(0) : 0;
-  std::for_each(component.trianglesValues.begin(),
-                component.trianglesValues.end(),
-                [&trianglesMinValue, &trianglesMaxValue](const double value) {
-                  trianglesMinValue = std::min(trianglesMinValue, value);
-                  trianglesMaxValue = std::max(trianglesMaxValue, value);
-                });
-
-  component.trianglesMinValue = trianglesMinValue;
-  component.trianglesMaxValue = trianglesMaxValue;
+  std::vector<double> trianglesMinMaxValue = Fields::component(
+      result.trianglesValues.data(), result.trianglesValues.size() / 3, 3,
+      index, component.trianglesValues);
+  component.trianglesMinValue = trianglesMinMaxValue.at(0);
+  component.trianglesMaxValue = trianglesMinMaxValue.at(1);
 
   return component;
 }
 
 /**
  * Write one
+ * The glb line is displayed by the caller
  * @param result Result
  * @param gltfFile GLTF file
+ * @param quantize Quantize the positions, values & indices
  * @return Status
  */
-bool writeOne(const Result &result, const std::string &gltfFile) {
+bool writeOne(const Result &result, const std::string &gltfFile,
+              const bool quantize) {
   bool res;
+  const ResultGeometry &geometry = *result.geometry;
   tinygltf::Model model;
   tinygltf::Scene scene;
   tinygltf::Asset asset;
 
   tinygltf::Material material;
 
-  tinygltf::Buffer polygonsBuffer;
-  tinygltf::BufferView polygonsBufferViewIndices;
-  tinygltf::BufferView polygonsBufferViewVertices;
-  tinygltf::BufferView polygonsBufferViewColors;
-  tinygltf::Accessor polygonsAccessorIndices;
-  tinygltf::Accessor polygonsAccessorVertices;
-  tinygltf::Accessor polygonsAccessorColors;
   tinygltf::Primitive polygonsPrimitive;
   tinygltf::Mesh polygonsMesh;
   tinygltf::Node polygonsNode;
 
-  tinygltf::Buffer trianglesBuffer;
-  tinygltf::BufferView trianglesBufferViewIndices;
-  tinygltf::BufferView trianglesBufferViewVertices;
-  tinygltf::BufferView trianglesBufferViewColors;
-  tinygltf::Accessor trianglesAccessorIndices;
-  tinygltf::Accessor trianglesAccessorVertices;
-  tinygltf::Accessor trianglesAccessorColors;
   tinygltf::Primitive trianglesPrimitive;
   tinygltf::Mesh trianglesMesh;
   tinygltf::Node trianglesNode;
 
+  // Buffer
+  model.buffers.push_back(tinygltf::Buffer());
+
   // Material
   material.pbrMetallicRoughness.metallicFactor = 0.25;
   material.doubleSided = true;
   model.materials.push_back(material);
 
-  // Indices (polygons)
-  uint sizeOfPolygons = 0;
-  std::for_each(result.polygons.begin(), result.polygons.end(),
-                [&polygonsBuffer, &sizeOfPolygons](const Polygon &polygon) {
-                  std::vector<uint> indices = polygon.getIndices();
-
-                  std::for_each(
-                      indices.begin(), indices.end(),
-                      [&polygonsBuffer, &sizeOfPolygons](const uint index) {
-                        sizeOfPolygons++;
-                        Utils::uintToBuffer(index, polygonsBuffer.data);
-                      });
-                });
-
-  // Padding (polygons)
-  size_t polygonsPaddingLength = polygonsBuffer.data.size() % 4;
-  for (size_t padding = 0; padding < polygonsPaddingLength; ++padding) {
-    polygonsBuffer.data.push_back(0x00);
-  }
-
-  // Vertices (polygons)
-  std::for_each(result.polygonsVertices.begin(), result.polygonsVertices.end(),
-                [&polygonsBuffer](const Vertex &vertex) {
-                  double x = vertex.X();
-                  double y = vertex.Y();
-                  double z = vertex.Z();
-
-                  // To buffer
-                  Utils::floatToBuffer((float)x, polygonsBuffer.data);
-                  Utils::floatToBuffer((float)y, polygonsBuffer.data);
-                  Utils::floatToBuffer((float)z, polygonsBuffer.data);
-                });
-
-  // Padding again (polygons)
-  size_t polygonsPaddingLength2 = polygonsBuffer.data.size() % 4;
-  for (size_t padding = 0; padding < polygonsPaddingLength2; ++padding) {
-    polygonsBuffer.data.push_back(0x00);
-  }
-
-  // Colors (polygons)
-  std::for_each(result.polygonsValues.begin(), result.polygonsValues.end(),
-                [&polygonsBuffer](const double value) {
-                  // To buffer
-                  Utils::floatToBuffer((float)value, polygonsBuffer.data);
-                });
-
-  // Indices (triangles)
-  std::for_each(result.triangles.begin(), result.triangles.end(),
-                [&trianglesBuffer](const Triangle triangle) {
-                  uint index1 = triangle.I1();
-                  uint index2 = triangle.I2();
-                  uint index3 = triangle.I3();
-
-                  // To buffer
-                  Utils::uintToBuffer(index1, trianglesBuffer.data);
-                  Utils::uintToBuffer(index2, trianglesBuffer.data);
-                  Utils::uintToBuffer(index3, trianglesBuffer.data);
-                });
-
-  // Padding (triangles)
-  size_t trianglesPaddingLength = trianglesBuffer.data.size() % 4;
-  for (size_t padding = 0; padding < trianglesPaddingLength; ++padding) {
-    trianglesBuffer.data.push_back(0x00);
-  }
-
-  // Vertices (triangles)
-  std::for_each(result.trianglesVertices.begin(),
-                result.trianglesVertices.end(),
-                [&trianglesBuffer](const Vertex &vertex) {
-                  double x = vertex.X();
-                  double y = vertex.Y();
-                  double z = vertex.Z();
-
-                  // To buffer
-                  Utils::floatToBuffer((float)x, trianglesBuffer.data);
-                  Utils::floatToBuffer((float)y, trianglesBuffer.data);
-                  Utils::floatToBuffer((float)z, trianglesBuffer.data);
-                });
-
-  // Padding again (triangles)
-  size_t trianglesPaddingLength2 = trianglesBuffer.data.size() % 4;
-  for (size_t padding = 0; padding < trianglesPaddingLength2; ++padding) {
-    trianglesBuffer.data.push_back(0x00);
-  }
-
-  // Colors (triangles)
-  std::for_each(result.trianglesValues.begin(), result.trianglesValues.end(),
-                [&trianglesBuffer](const double value) {
-                  // To buffer
-                  Utils::floatToBuffer((float)value, trianglesBuffer.data);
-                });
+  // Range, shared by the polygons & triangles values
+  const std::vector<std::vector<double>> range = valuesRange(result);
 
   std::string polygonsUuid = Utils::uuid();
-  if (sizeOfPolygons) {
-    // Model (polygons)
-    model.buffers.push_back(polygonsBuffer);
-
-    // Buffer views (polygons)
-    polygonsBufferViewIndices.buffer = (int)model.buffers.size() - 1;
-    polygonsBufferViewIndices.byteOffset = 0;
-    polygonsBufferViewIndices.byteLength = sizeOfPolygons * __SIZEOF_INT__;
-    polygonsBufferViewIndices.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
-    model.bufferViews.push_back(polygonsBufferViewIndices);
-
-    polygonsBufferViewVertices.buffer = (int)model.buffers.size() - 1;
-    polygonsBufferViewVertices.byteOffset =
-        sizeOfPolygons * __SIZEOF_INT__ + polygonsPaddingLength;
-    polygonsBufferViewVertices.byteLength =
-        result.polygonsVertices.size() * 3 * __SIZEOF_FLOAT__;
-    polygonsBufferViewVertices.target = TINYGLTF_TARGET_ARRAY_BUFFER;
-    model.bufferViews.push_back(polygonsBufferViewVertices);
-
-    polygonsBufferViewColors.buffer = (int)model.buffers.size() - 1;
-    polygonsBufferViewColors.byteOffset =
-        sizeOfPolygons * __SIZEOF_INT__ + polygonsPaddingLength +
-        result.polygonsVertices.size() * 3 * __SIZEOF_FLOAT__ +
-        polygonsPaddingLength2;
-    polygonsBufferViewColors.byteLength =
-        result.polygonsValues.size() * __SIZEOF_FLOAT__;
-    polygonsBufferViewColors.target = TINYGLTF_TARGET_ARRAY_BUFFER;
-    model.bufferViews.push_back(polygonsBufferViewColors);
-
-    // Accessors (polygons)
-    polygonsAccessorIndices.bufferView = (int)model.bufferViews.size() - 3;
-    polygonsAccessorIndices.byteOffset = 0;
-    polygonsAccessorIndices.componentType =
-        TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
-    polygonsAccessorIndices.count = sizeOfPolygons;
-    polygonsAccessorIndices.type = TINYGLTF_TYPE_SCALAR;
-    polygonsAccessorIndices.minValues.push_back(result.polygonsMinIndex);
-    polygonsAccessorIndices.maxValues.push_back(result.polygonsMaxIndex);
-    model.accessors.push_back(polygonsAccessorIndices);
-
-    polygonsAccessorVertices.bufferView = (int)model.bufferViews.size() - 2;
-    polygonsAccessorVertices.byteOffset = 0;
-    polygonsAccessorVertices.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-    polygonsAccessorVertices.count = result.polygonsVertices.size();
-    polygonsAccessorVertices.type = TINYGLTF_TYPE_VEC3;
-    polygonsAccessorVertices.minValues = {result.polygonsMinVertex.X(),
-                                          result.polygonsMinVertex.Y(),
-                                          result.polygonsMinVertex.Z()};
-    polygonsAccessorVertices.maxValues = {result.polygonsMaxVertex.X(),
-                                          result.polygonsMaxVertex.Y(),
-                                          result.polygonsMaxVertex.Z()};
-    model.accessors.push_back(polygonsAccessorVertices);
-
-    polygonsAccessorColors.bufferView = (int)model.bufferViews.size() - 1;
-    polygonsAccessorColors.byteOffset = 0;
-    polygonsAccessorColors.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-    polygonsAccessorColors.count = result.polygonsValues.size();
-    polygonsAccessorColors.type = TINYGLTF_TYPE_SCALAR;
-    polygonsAccessorColors.minValues.push_back(result.polygonsMinValue);
-    polygonsAccessorColors.maxValues.push_back(result.polygonsMaxValue);
-    model.accessors.push_back(polygonsAccessorColors);
-
+  if (!geometry.polygons.getIndices().empty()) {
     // Primitive (polygons)
-    polygonsPrimitive.indices = (int)model.accessors.size() - 3;
-    polygonsPrimitive.attributes["POSITION"] = (int)model.accessors.size() - 2;
-    polygonsPrimitive.attributes["DATA"] = (int)model.accessors.size() - 1;
+    polygonsPrimitive.attributes["POSITION"] = appendVertices(
+        geometry.polygonsVertices, geometry.polygonsMinVertex,
+        geometry.polygonsMaxVertex, quantize, model);
+    polygonsPrimitive.attributes["DATA"] =
+        appendValues(result.polygonsValues, 1, range, quantize, model);
     polygonsPrimitive.material = (int)model.materials.size() - 1;
-    polygonsPrimitive.mode = TINYGLTF_MODE_LINE_STRIP;
 
     // Mesh (polygons)
     polygonsMesh.name = "Line";
     polygonsMesh.extras =
         tinygltf::Value({{"uuid", tinygltf::Value(polygonsUuid)},
                          {"label", tinygltf::Value(1)}});
-    polygonsMesh.primitives.push_back(polygonsPrimitive);
+    addPolylinesPrimitives(geometry, quantize, polygonsPrimitive, model,
+                           polygonsMesh);
     model.meshes.push_back(polygonsMesh);
 
     // Node (polygons)
     polygonsNode.mesh = (int)model.meshes.size() - 1;
+    if (quantize)
+      setDequantization(geometry.polygonsMinVertex, geometry.polygonsMaxVertex,
+                        polygonsNode);
     model.nodes.push_back(polygonsNode);
 
     // Scene (polygons)
-    if (polygonsBuffer.data.size())
-      scene.nodes.push_back((int)model.nodes.size() - 1);
+    scene.nodes.push_back((int)model.nodes.size() - 1);
   }
 
-  // Model (triangles)
-  model.buffers.push_back(trianglesBuffer);
-
-  // Buffer views (triangles)
-  trianglesBufferViewIndices.buffer = (int)model.buffers.size() - 1;
-  trianglesBufferViewIndices.byteOffset = 0;
-  trianglesBufferViewIndices.byteLength =
-      result.triangles.size() * 3 * __SIZEOF_INT__;
-  trianglesBufferViewIndices.target = TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER;
-  model.bufferViews.push_back(trianglesBufferViewIndices);
-
-  trianglesBufferViewVertices.buffer = (int)model.buffers.size() - 1;
-  trianglesBufferViewVertices.byteOffset =
-      result.triangles.size() * 3 * __SIZEOF_INT__ + trianglesPaddingLength;
-  trianglesBufferViewVertices.byteLength =
-      result.trianglesVertices.size() * 3 * __SIZEOF_FLOAT__;
-  trianglesBufferViewVertices.target = TINYGLTF_TARGET_ARRAY_BUFFER;
-  model.bufferViews.push_back(trianglesBufferViewVertices);
-
-  trianglesBufferViewColors.buffer = (int)model.buffers.size() - 1;
-  trianglesBufferViewColors.byteOffset =
-      result.triangles.size() * 3 * __SIZEOF_INT__ + trianglesPaddingLength +
-      result.trianglesVertices.size() * 3 * __SIZEOF_FLOAT__ +
-      trianglesPaddingLength2;
-  trianglesBufferViewColors.byteLength =
-      result.trianglesValues.size() * __SIZEOF_FLOAT__;
-  trianglesBufferViewColors.target = TINYGLTF_TARGET_ARRAY_BUFFER;
-  model.bufferViews.push_back(trianglesBufferViewColors);
-
-  // Accessors (triangle)
-  trianglesAccessorIndices.bufferView = (int)model.bufferViews.size() - 3;
-  trianglesAccessorIndices.byteOffset = 0;
-  trianglesAccessorIndices.componentType = TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
-  trianglesAccessorIndices.count = result.triangles.size() * 3;
-  trianglesAccessorIndices.type = TINYGLTF_TYPE_SCALAR;
-  trianglesAccessorIndices.minValues.push_back(result.trianglesMinIndex);
-  trianglesAccessorIndices.maxValues.push_back(result.trianglesMaxIndex);
-  model.accessors.push_back(trianglesAccessorIndices);
-
-  trianglesAccessorVertices.bufferView = (int)model.bufferViews.size() - 2;
-  trianglesAccessorVertices.byteOffset = 0;
-  trianglesAccessorVertices.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-  trianglesAccessorVertices.count = result.trianglesVertices.size();
-  trianglesAccessorVertices.type = TINYGLTF_TYPE_VEC3;
-  trianglesAccessorVertices.minValues = {result.trianglesMinVertex.X(),
-                                         result.trianglesMinVertex.Y(),
-                                         result.trianglesMinVertex.Z()};
-  trianglesAccessorVertices.maxValues = {result.trianglesMaxVertex.X(),
-                                         result.trianglesMaxVertex.Y(),
-                                         result.trianglesMaxVertex.Z()};
-  model.accessors.push_back(trianglesAccessorVertices);
-
-  trianglesAccessorColors.bufferView = (int)model.bufferViews.size() - 1;
-  trianglesAccessorColors.byteOffset = 0;
-  trianglesAccessorColors.componentType = TINYGLTF_COMPONENT_TYPE_FLOAT;
-  trianglesAccessorColors.count = result.trianglesValues.size();
-  trianglesAccessorColors.type = TINYGLTF_TYPE_SCALAR;
-  trianglesAccessorColors.minValues.push_back(result.trianglesMinValue);
-  trianglesAccessorColors.maxValues.push_back(result.trianglesMaxValue);
-  model.accessors.push_back(trianglesAccessorColors);
+  // Indices (triangles)
+  std::vector<uint> indices;
+  indices.reserve(geometry.triangles.size() * 3);
+  std::for_each(geometry.triangles.begin(), geometry.triangles.end(),
+                [&indices](const Triangle &triangle) {
+                  indices.push_back(triangle.I1());
+                  indices.push_back(triangle.I2());
+                  indices.push_back(triangle.I3());
+                });
 
   // Primitive (triangles)
-  trianglesPrimitive.indices = (int)model.accessors.size() - 3;
-  trianglesPrimitive.attributes["POSITION"] = (int)model.accessors.size() - 2;
-  trianglesPrimitive.attributes["DATA"] = (int)model.accessors.size() - 1;
+  trianglesPrimitive.indices =
+      appendIndices(indices, geometry.trianglesMinIndex,
+                    geometry.trianglesMaxIndex, quantize, model);
+  trianglesPrimitive.attributes["POSITION"] = appendVertices(
+      geometry.trianglesVertices, geometry.trianglesMinVertex,
+      geometry.trianglesMaxVertex, quantize, model);
+  trianglesPrimitive.attributes["DATA"] =
+      appendValues(result.trianglesValues, 1, range, quantize, model);
   trianglesPrimitive.material = (int)model.materials.size() - 1;
   trianglesPrimitive.mode = TINYGLTF_MODE_TRIANGLES;
 
@@ -513,33 +448,45 @@ bool writeOne(const Result &result, const std::string &gltfFile) {
   trianglesMesh.extras =
       tinygltf::Value({{"uuid", tinygltf::Value(trianglesUuid)},
                        {"label", tinygltf::Value(1)}});
-  trianglesMesh.primitives.push_back(trianglesPrimitive);
+  addTrianglesPrimitives(geometry, trianglesPrimitive, model, trianglesMesh);
   model.meshes.push_back(trianglesMesh);
 
   // Node (triangle)
   trianglesNode.mesh = (int)model.meshes.size() - 1;
+  if (quantize)
+    setDequantization(geometry.trianglesMinVertex, geometry.trianglesMaxVertex,
+                      trianglesNode);
   model.nodes.push_back(trianglesNode);
 
   // Scene (triangles)
-  if (trianglesBuffer.data.size())
+  if (geometry.triangles.size())
     scene.nodes.push_back((int)model.nodes.size() - 1);
 
   // Scene
   scene.name = "master";
-  scene.extras = tinygltf::Value(
-      {{"type", tinygltf::Value(std::string("result"))},
-       {"uuid", tinygltf::Value(Utils::uuid())},
-       {"dimension", tinygltf::Value(3)},
-       {"faces", tinygltf::Value({{"name", tinygltf::Value(trianglesMesh.name)},
-                                  {"uuid", tinygltf::Value(trianglesUuid)},
-                                  {"label", tinygltf::Value(1)}})},
-       {"edges", tinygltf::Value({{"name", tinygltf::Value(polygonsMesh.name)},
-                                  {"uuid", tinygltf::Value(polygonsUuid)},
-                                  {"label", tinygltf::Value(1)}})}});
+  tinygltf::Value::Object extras = {
+      {"type", tinygltf::Value(std::string("result"))},
+      {"uuid", tinygltf::Value(Utils::uuid())},
+      {"dimension", tinygltf::Value(3)},
+      {"faces", tinygltf::Value({{"name", tinygltf::Value(trianglesMesh.name)},
+                                 {"uuid", tinygltf::Value(trianglesUuid)},
+                                 {"label", tinygltf::Value(1)}})},
+      {"edges", tinygltf::Value({{"name", tinygltf::Value(polygonsMesh.name)},
+                                 {"uuid", tinygltf::Value(polygonsUuid)},
+                                 {"label", tinygltf::Value(1)}})}};
+  if (quantize)
+    extras["range"] = rangeExtras(range);
+  scene.extras = tinygltf::Value(extras);
 
   // Scenes
   model.scenes.push_back(scene);
 
+  // Extensions
+  if (quantize) {
+    model.extensionsUsed.push_back("KHR_mesh_quantization");
+    model.extensionsRequired.push_back("KHR_mesh_quantization");
+  }
+
   // Asset
   asset.version = "2.0";
   asset.generator = "Tanatloc-VTUToGLTF";
@@ -556,8 +503,699 @@ bool writeOne(const Result &result, const std::string &gltfFile) {
     return false;
   }
 
-  Logger::DISP(R"({ "glb": ")" + gltfFile + R"(", "name": ")" + result.name +
-               R"(" })");
+  return true;
+}
+
+/**
+ * Add triangles primitives
+ * One primitive per piece, over the same buffer views, if not welded
+ * @param geometry Result geometry
+ * @param primitive Triangles primitive, indexing all triangles
+ * @param model Model
+ * @param mesh Mesh
+ */
+void addTrianglesPrimitives(const ResultGeometry &geometry,
+                            const tinygltf::Primitive &primitive,
+                            tinygltf::Model &model, tinygltf::Mesh &mesh) {
+  if (geometry.trianglesPieces.size() <= 2) {
+    mesh.primitives.push_back(primitive);
+    return;
+  }
+
+  const tinygltf::Accessor accessorIndices =
+      model.accessors.at(primitive.indices);
+  const size_t sizeOfIndex =
+      accessorIndices.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
+          ? __SIZEOF_SHORT__
+          : __SIZEOF_INT__;
+  for (size_t piece = 0; piece + 1 < geometry.trianglesPieces.size();
+       ++piece) {
+    const size_t begin = geometry.trianglesPieces.at(piece);
+    const size_t end = geometry.trianglesPieces.at(piece + 1);
+    std::vector<uint> pieceMinMaxIndex = Utils::minMax(
+        std::vector<Triangle>(geometry.triangles.begin() + begin,
+                              geometry.triangles.begin() + end));
+
+    tinygltf::Accessor pieceAccessorIndices = accessorIndices;
+    pieceAccessorIndices.byteOffset =
+        accessorIndices.byteOffset + begin * 3 * sizeOfIndex;
+    pieceAccessorIndices.count = (end - begin) * 3;
+    pieceAccessorIndices.minValues = {(double)pieceMinMaxIndex.at(0)};
+    pieceAccessorIndices.maxValues = {(double)pieceMinMaxIndex.at(1)};
+    model.accessors.push_back(pieceAccessorIndices);
+
+    tinygltf::Primitive piecePrimitive = primitive;
+    piecePrimitive.indices = (int)model.accessors.size() - 1;
+    mesh.primitives.push_back(piecePrimitive);
+  }
+}
+
+/**
+ * Append buffer view
+ * The data is appended to the last buffer, 4 bytes aligned
+ * @param data Data
+ * @param target Target
+ * @param model Model
+ * @param byteStride Byte stride, 0 for tightly packed data
+ * @return Buffer view
+ */
+int appendBufferView(const std::vector<unsigned char> &data, const int target,
+                     tinygltf::Model &model, const size_t byteStride) {
+  tinygltf::Buffer &buffer = model.buffers.back();
+
+  // Padding
+  size_t paddingLength = (4 - buffer.data.size() % 4) % 4;
+  for (size_t padding = 0; padding < paddingLength; ++padding) {
+    buffer.data.push_back(0x00);
+  }
+
+  tinygltf::BufferView bufferView;
+  bufferView.buffer = (int)model.buffers.size() - 1;
+  bufferView.byteOffset = buffer.data.size();
+  bufferView.byteLength = data.size();
+  bufferView.byteStride = byteStride;
+  bufferView.target = target;
+  model.bufferViews.push_back(bufferView);
+
+  buffer.data.insert(buffer.data.end(), data.begin(), data.end());
+
+  return (int)model.bufferViews.size() - 1;
+}
+
+/**
+ * Append accessor
+ * @param bufferView Buffer view
+ * @param componentType Component type
+ * @param count Count
+ * @param type Type
+ * @param minValues Min values
+ * @param maxValues Max values
+ * @param model Model
+ * @return Accessor
+ */
+int appendAccessor(const int bufferView, const int componentType,
+                   const size_t count, const int type,
+                   const std::vector<double> &minValues,
+                   const std::vector<double> &maxValues,
+                   tinygltf::Model &model) {
+  tinygltf::Accessor accessor;
+  accessor.bufferView = bufferView;
+  accessor.byteOffset = 0;
+  accessor.componentType = componentType;
+  accessor.count = count;
+  accessor.type = type;
+  accessor.minValues = minValues;
+  accessor.maxValues = maxValues;
+  model.accessors.push_back(accessor);
+
+  return (int)model.accessors.size() - 1;
+}
+
+/**
+ * Append indices
+ * Unsigned shorts if quantized and the max index fits, unsigned ints otherwise
+ * @param indices Indices
+ * @param minIndex Min index
+ * @param maxIndex Max index
+ * @param quantize Quantize
+ * @param model Model
+ * @return Indices accessor
+ */
+int appendIndices(const std::vector<uint> &indices, const uint minIndex,
+                  const uint maxIndex, const bool quantize,
+                  tinygltf::Model &model) {
+  // 65535 is the primitive restart value
+  const bool narrow = quantize && maxIndex < 65535;
+
+  std::vector<unsigned char> data;
+  data.reserve(indices.size() * (narrow ? __SIZEOF_SHORT__ : __SIZEOF_INT__));
+  std::for_each(indices.begin(), indices.end(),
+                [&data, narrow](const uint index) {
+                  // To buffer
+                  if (narrow)
+                    Utils::ushortToBuffer((unsigned short)index, data);
+                  else
+                    Utils::uintToBuffer(index, data);
+                });
+
+  return appendAccessor(
+      appendBufferView(data, TINYGLTF_TARGET_ELEMENT_ARRAY_BUFFER, model),
+      narrow ? TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT
+             : TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT,
+      indices.size(), TINYGLTF_TYPE_SCALAR, {(double)minIndex},
+      {(double)maxIndex}, model);
+}
+
+/**
+ * Add polylines primitives
+ * One polyline is a LINE_STRIP. Several polylines are LINES index pairs, so
+ * that they are not joined, still drawn in one call. Strips with a restart
+ * index are not allowed by glTF. One point polylines (vertex cells), which
+ * have no segment, are a POINTS primitive
+ * @param geometry Result geometry
+ * @param quantize Quantize
+ * @param primitive Polylines primitive, attributes & material set
+ * @param model Model
+ * @param mesh Mesh
+ */
+void addPolylinesPrimitives(const ResultGeometry &geometry,
+                            const bool quantize,
+                            const tinygltf::Primitive &primitive,
+                            tinygltf::Model &model, tinygltf::Mesh &mesh) {
+  const Polylines &polylines = geometry.polygons;
+
+  if (polylines.size() == 1 && polylines.getIndices().size() > 1) {
+    tinygltf::Primitive stripPrimitive = primitive;
+    stripPrimitive.indices = appendIndices(
+        polylines.getIndices(), geometry.polygonsMinIndex,
+        geometry.polygonsMaxIndex, quantize, model);
+    stripPrimitive.mode = TINYGLTF_MODE_LINE_STRIP;
+    mesh.primitives.push_back(stripPrimitive);
+    return;
+  }
+
+  // Segments, then points, each skipped if empty
+  const std::vector<std::pair<std::vector<uint>, int>> parts = {
+      {polylines.getSegments(), TINYGLTF_MODE_LINE},
+      {polylines.getPoints(), TINYGLTF_MODE_POINTS}};
+  for (const auto &[indices, mode] : parts) {
+    if (indices.empty())
+      continue;
+    const auto minMax = std::minmax_element(indices.begin(), indices.end());
+    tinygltf::Primitive partPrimitive = primitive;
+    partPrimitive.indices = appendIndices(indices, *minMax.first,
+                                          *minMax.second, quantize, model);
+    partPrimitive.mode = mode;
+    mesh.primitives.push_back(partPrimitive);
+  }
+}
+
+/**
+ * Append vertices
+ * If quantized, normalized unsigned shorts over the bounding box, see
+ * setDequantization (KHR_mesh_quantization)
+ * @param vertices Vertices
+ * @param minVertex Min vertex
+ * @param maxVertex Max vertex
+ * @param quantize Quantize
+ * @param model Model
+ * @return POSITION accessor
+ */
+int appendVertices(const std::vector<Vertex> &vertices, const Vertex &minVertex,
+                   const Vertex &maxVertex, const bool quantize,
+                   tinygltf::Model &model) {
+  const std::vector<double> minValues = {minVertex.X(), minVertex.Y(),
+                                         minVertex.Z()};
+  const std::vector<double> maxValues = {maxVertex.X(), maxVertex.Y(),
+                                         maxVertex.Z()};
+  std::vector<unsigned char> data;
+
+  if (quantize) {
+    std::vector<double> coordinates;
+    coordinates.reserve(vertices.size() * 3);
+    std::for_each(vertices.begin(), vertices.end(),
+                  [&coordinates](const Vertex &vertex) {
+                    coordinates.push_back(vertex.X());
+                    coordinates.push_back(vertex.Y());
+                    coordinates.push_back(vertex.Z());
+                  });
+    const size_t byteStride = Fields::quantize(
+        coordinates.data(), vertices.size(), 3, minValues, maxValues, data);
+
+    // The bounding box maps to [0, 65535], a flat axis to 0
+    std::vector<double> maxQuantized(3, 0);
+    for (int k = 0; k < 3; ++k)
+      maxQuantized[k] = maxValues[k] > minValues[k] ? 65535 : 0;
+
+    const int accessor = appendAccessor(
+        appendBufferView(data, TINYGLTF_TARGET_ARRAY_BUFFER, model,
+                         byteStride),
+        TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, vertices.size(),
+        TINYGLTF_TYPE_VEC3, {0, 0, 0}, maxQuantized, model);
+    model.accessors.at(accessor).normalized = true;
+    return accessor;
+  }
+
+  data.reserve(vertices.size() * 3 * __SIZEOF_FLOAT__);
+  std::for_each(vertices.begin(), vertices.end(),
+                [&data](const Vertex &vertex) {
+                  // To buffer
+                  Utils::floatToBuffer((float)vertex.X(), data);
+                  Utils::floatToBuffer((float)vertex.Y(), data);
+                  Utils::floatToBuffer((float)vertex.Z(), data);
+                });
+
+  const int bufferView =
+      appendBufferView(data, TINYGLTF_TARGET_ARRAY_BUFFER, model);
+  return appendAccessor(bufferView, TINYGLTF_COMPONENT_TYPE_FLOAT,
+                        vertices.size(), TINYGLTF_TYPE_VEC3, minValues,
+                        maxValues, model);
+}
+
+/**
+ * Set dequantization
+ * Node translation & scale mapping the quantized positions back to the
+ * bounding box
+ * @param minVertex Min vertex
+ * @param maxVertex Max vertex
+ * @param node Node
+ */
+void setDequantization(const Vertex &minVertex, const Vertex &maxVertex,
+                       tinygltf::Node &node) {
+  const double x = maxVertex.X() - minVertex.X();
+  const double y = maxVertex.Y() - minVertex.Y();
+  const double z = maxVertex.Z() - minVertex.Z();
+
+  node.translation = {minVertex.X(), minVertex.Y(), minVertex.Z()};
+  node.scale = {x > 0 ? x : 1, y > 0 ? y : 1, z > 0 ? z : 1};
+}
+
+/**
+ * Values range
+ * Per component min / max over the polygons & triangles values, shared by
+ * their quantized accessors
+ * @param result Result
+ * @return { min values, max values }
+ */
+std::vector<std::vector<double>> valuesRange(const Result &result) {
+  std::vector<double> minValues(result.size, 0);
+  std::vector<double> maxValues(result.size, 0);
+
+  bool first = true;
+  for (const std::vector<float> *values :
+       {&result.polygonsValues, &result.trianglesValues}) {
+    if (values->empty())
+      continue;
+
+    for (uint k = 0; k < result.size; ++k) {
+      std::vector<double> minMax = Fields::range(
+          values->data(), values->size() / result.size, result.size, k);
+      minValues[k] = first ? minMax.at(0) : std::min(minValues[k], minMax[0]);
+      maxValues[k] = first ? minMax.at(1) : std::max(maxValues[k], minMax[1]);
+    }
+    first = false;
+  }
+
+  return {minValues, maxValues};
+}
+
+/**
+ * Range extras
+ * @param range { min values, max values }
+ * @return { "min": [...], "max": [...] }
+ */
+tinygltf::Value rangeExtras(const std::vector<std::vector<double>> &range) {
+  std::vector<tinygltf::Value> minValues;
+  std::vector<tinygltf::Value> maxValues;
+  for (size_t k = 0; k < range.at(0).size(); ++k) {
+    minValues.push_back(tinygltf::Value(range.at(0).at(k)));
+    maxValues.push_back(tinygltf::Value(range.at(1).at(k)));
+  }
+
+  return tinygltf::Value({{"min", tinygltf::Value(minValues)},
+                          {"max", tinygltf::Value(maxValues)}});
+}
+
+/**
+ * Append values
+ * If quantized, normalized unsigned shorts over the range, without min / max
+ * @param values Values
+ * @param size Number of components, 1 or 3
+ * @param range { min values, max values }, used if quantized
+ * @param quantize Quantize
+ * @param model Model
+ * @return Accessor
+ */
+int appendValues(const std::vector<float> &values, const int size,
+                 const std::vector<std::vector<double>> &range,
+                 const bool quantize, tinygltf::Model &model) {
+  std::vector<unsigned char> data;
+
+  if (quantize) {
+    const size_t byteStride =
+        Fields::quantize(values.data(), values.size() / size, size,
+                         range.at(0), range.at(1), data);
+
+    const int accessor = appendAccessor(
+        appendBufferView(data, TINYGLTF_TARGET_ARRAY_BUFFER, model,
+                         byteStride),
+        TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT, values.size() / size,
+        size == 3 ? TINYGLTF_TYPE_VEC3 : TINYGLTF_TYPE_SCALAR, {}, {}, model);
+    model.accessors.at(accessor).normalized = true;
+    return accessor;
+  }
+
+  data.reserve(values.size() * __SIZEOF_FLOAT__);
+  std::for_each(values.begin(), values.end(), [&data](const float value) {
+    // To buffer
+    Utils::floatToBuffer(value, data);
+  });
+
+  // Per component min / max
+  std::vector<double> minValues(size, 0);
+  std::vector<double> maxValues(size, 0);
+  for (int k = 0; k < size; ++k) {
+    std::vector<double> minMax =
+        Fields::range(values.data(), values.size() / size, size, k);
+    minValues[k] = minMax.at(0);
+    maxValues[k] = minMax.at(1);
+  }
+
+  const int bufferView =
+      appendBufferView(data, TINYGLTF_TARGET_ARRAY_BUFFER, model);
+  return appendAccessor(bufferView, TINYGLTF_COMPONENT_TYPE_FLOAT,
+                        values.size() / size,
+                        size == 3 ? TINYGLTF_TYPE_VEC3 : TINYGLTF_TYPE_SCALAR,
+                        minValues, maxValues, model);
+}
+
+/**
+ * Append fields
+ * Values of each result (SCALAR, or VEC3 for vectors) in their own buffer
+ * views
+ * @param results Results, sharing the model geometry
+ * @param resultModel Result model
+ * @param polygonsAccessors Polygons accessors, -1 without polygons
+ * @param trianglesAccessors Triangles accessors
+ * @param ranges Ranges extras, if quantized
+ * @return Status, false if the fields differ from the model ones
+ */
+bool appendFields(const std::vector<Result> &results, ResultModel &resultModel,
+                  std::vector<int> &polygonsAccessors,
+                  std::vector<int> &trianglesAccessors,
+                  std::vector<tinygltf::Value> &ranges) {
+  std::vector<std::string> names;
+  std::for_each(
+      results.begin(), results.end(),
+      [&names, &resultModel, &polygonsAccessors, &trianglesAccessors,
+       &ranges](const Result &result) {
+        if (result.size != 1 && result.size != 3)
+          return;
+        names.push_back(result.name);
+
+        const std::vector<std::vector<double>> range = valuesRange(result);
+        if (resultModel.quantize)
+          ranges.push_back(rangeExtras(range));
+
+        polygonsAccessors.push_back(
+            !result.geometry->polygons.getIndices().empty()
+                ? appendValues(result.polygonsValues, result.size, range,
+                               resultModel.quantize, resultModel.model)
+                : -1);
+        trianglesAccessors.push_back(
+            appendValues(result.trianglesValues, result.size, range,
+                         resultModel.quantize, resultModel.model));
+      });
+
+  if (resultModel.names.empty()) {
+    resultModel.names = names;
+  } else if (names != resultModel.names) {
+    Logger::ERROR("Fields different from the first step");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Build model
+ * Geometry written once, with one _DATA_<name> attribute per result
+ * @param results Results, sharing the same geometry
+ * @param resultModel Result model
+ * @return Status
+ */
+bool buildModel(const std::vector<Result> &results, ResultModel &resultModel) {
+  tinygltf::Model &model = resultModel.model;
+  tinygltf::Material material;
+
+  if (results.empty()) {
+    Logger::ERROR("No result to write");
+    return false;
+  }
+  const ResultGeometry &geometry = *results.front().geometry;
+
+  // Buffer
+  model.buffers.push_back(tinygltf::Buffer());
+
+  // Material
+  material.pbrMetallicRoughness.metallicFactor = 0.25;
+  material.doubleSided = true;
+  model.materials.push_back(material);
+
+  // Fields
+  if (!appendFields(results, resultModel, resultModel.polygonsAccessors,
+                    resultModel.trianglesAccessors, resultModel.ranges))
+    return false;
+
+  std::vector<tinygltf::Value> fieldsExtras;
+  for (size_t i = 0; i < resultModel.names.size(); ++i) {
+    const std::string &name = resultModel.names.at(i);
+    const auto result =
+        std::find_if(results.begin(), results.end(),
+                     [&name](const Result &r) { return r.name == name; });
+    tinygltf::Value::Object fieldExtras = {
+        {"name", tinygltf::Value(name)},
+        {"attribute", tinygltf::Value("_DATA_" + name)},
+        {"size", tinygltf::Value((int)result->size)}};
+    if (resultModel.quantize)
+      fieldExtras["range"] = resultModel.ranges.at(i);
+    fieldsExtras.push_back(tinygltf::Value(fieldExtras));
+  }
+
+  // Polygons
+  std::string polygonsUuid = Utils::uuid();
+  std::string polygonsName = "Line";
+  if (!geometry.polygons.getIndices().empty()) {
+    tinygltf::Primitive primitive;
+    tinygltf::Mesh mesh;
+    tinygltf::Node node;
+
+    primitive.attributes["POSITION"] = appendVertices(
+        geometry.polygonsVertices, geometry.polygonsMinVertex,
+        geometry.polygonsMaxVertex, resultModel.quantize, model);
+    for (size_t i = 0; i < resultModel.names.size(); ++i)
+      primitive.attributes["_DATA_" + resultModel.names.at(i)] =
+          resultModel.polygonsAccessors.at(i);
+    primitive.material = (int)model.materials.size() - 1;
+
+    mesh.name = polygonsName;
+    mesh.extras = tinygltf::Value({{"uuid", tinygltf::Value(polygonsUuid)},
+                                   {"label", tinygltf::Value(1)}});
+    addPolylinesPrimitives(geometry, resultModel.quantize, primitive, model,
+                           mesh);
+    model.meshes.push_back(mesh);
+
+    node.mesh = (int)model.meshes.size() - 1;
+    if (resultModel.quantize)
+      setDequantization(geometry.polygonsMinVertex,
+                        geometry.polygonsMaxVertex, node);
+    model.nodes.push_back(node);
+    resultModel.scene.nodes.push_back((int)model.nodes.size() - 1);
+  }
+
+  // Triangles
+  std::string trianglesUuid = Utils::uuid();
+  std::string trianglesName = "Face";
+  {
+    tinygltf::Primitive primitive;
+    tinygltf::Mesh mesh;
+    tinygltf::Node node;
+
+    std::vector<uint> indices;
+    indices.reserve(geometry.triangles.size() * 3);
+    std::for_each(geometry.triangles.begin(), geometry.triangles.end(),
+                  [&indices](const Triangle &triangle) {
+                    indices.push_back(triangle.I1());
+                    indices.push_back(triangle.I2());
+                    indices.push_back(triangle.I3());
+                  });
+
+    primitive.indices =
+        appendIndices(indices, geometry.trianglesMinIndex,
+                      geometry.trianglesMaxIndex, resultModel.quantize, model);
+    primitive.attributes["POSITION"] = appendVertices(
+        geometry.trianglesVertices, geometry.trianglesMinVertex,
+        geometry.trianglesMaxVertex, resultModel.quantize, model);
+    for (size_t i = 0; i < resultModel.names.size(); ++i)
+      primitive.attributes["_DATA_" + resultModel.names.at(i)] =
+          resultModel.trianglesAccessors.at(i);
+    primitive.material = (int)model.materials.size() - 1;
+    primitive.mode = TINYGLTF_MODE_TRIANGLES;
+
+    mesh.name = trianglesName;
+    mesh.extras = tinygltf::Value({{"uuid", tinygltf::Value(trianglesUuid)},
+                                   {"label", tinygltf::Value(1)}});
+    addTrianglesPrimitives(geometry, primitive, model, mesh);
+    model.meshes.push_back(mesh);
+
+    node.mesh = (int)model.meshes.size() - 1;
+    if (resultModel.quantize)
+      setDequantization(geometry.trianglesMinVertex,
+                        geometry.trianglesMaxVertex, node);
+    model.nodes.push_back(node);
+    if (geometry.triangles.size())
+      resultModel.scene.nodes.push_back((int)model.nodes.size() - 1);
+  }
+
+  // Scene extras
+  resultModel.extras = {
+      {"type", tinygltf::Value(std::string("result"))},
+      {"uuid", tinygltf::Value(Utils::uuid())},
+      {"dimension", tinygltf::Value(3)},
+      {"fields", tinygltf::Value(fieldsExtras)},
+      {"faces", tinygltf::Value({{"name", tinygltf::Value(trianglesName)},
+                                 {"uuid", tinygltf::Value(trianglesUuid)},
+                                 {"label", tinygltf::Value(1)}})},
+      {"edges", tinygltf::Value({{"name", tinygltf::Value(polygonsName)},
+                                 {"uuid", tinygltf::Value(polygonsUuid)},
+                                 {"label", tinygltf::Value(1)}})}};
+
+  return true;
+}
+
+/**
+ * Write model
+ * @param resultModel Result model
+ * @param gltfFile GLTF file
+ * @return Status
+ */
+bool writeModel(ResultModel &resultModel, const std::string &gltfFile) {
+  tinygltf::Model &model = resultModel.model;
+  tinygltf::Asset asset;
+
+  // Scene
+  resultModel.scene.name = "master";
+  resultModel.scene.extras = tinygltf::Value(resultModel.extras);
+
+  // Scenes
+  model.scenes.push_back(resultModel.scene);
+
+  // Extensions
+  if (resultModel.quantize) {
+    model.extensionsUsed.push_back("KHR_mesh_quantization");
+    model.extensionsRequired.push_back("KHR_mesh_quantization");
+  }
+
+  // Asset
+  asset.version = "2.0";
+  asset.generator = "Tanatloc-VTUToGLTF";
+  model.asset = asset;
+
+  tinygltf::TinyGLTF gltf;
+  bool res = gltf.WriteGltfSceneToFile(&model, gltfFile,
+                                       true,  // embedImages
+                                       true,  // embedBuffers
+                                       false, // pretty print
+                                       true); // write binary
+  if (!res) {
+    Logger::ERROR("Unable to write glft file " + gltfFile);
+    return false;
+  }
+
+  std::string jsonNames;
+  for (const std::string &name : resultModel.names)
+    jsonNames += (jsonNames.empty() ? "\"" : ", \"") + name + "\"";
+  Logger::DISP(R"({ "glb": ")" + gltfFile + R"(", "names": [)" + jsonNames +
+               "] }");
 
   return true;
 }
+
+/**
+ * Write all
+ * Geometry written once, with one _DATA_<name> attribute per result
+ * (SCALAR, or VEC3 for vectors)
+ * @param results Results, sharing the same geometry
+ * @param quantize Quantize the positions, values & indices
+ * @param gltfFile GLTF file
+ * @return Status
+ */
+bool writeAll(const std::vector<Result> &results, const bool quantize,
+              const std::string &gltfFile) {
+  ResultModel resultModel;
+  resultModel.quantize = quantize;
+  if (!buildModel(results, resultModel))
+    return false;
+
+  return writeModel(resultModel, gltfFile);
+}
+
+/**
+ * Write steps
+ * The geometry and its remap are built from the first step only, the next
+ * steps only read their fields, appended in their own buffer views. The
+ * attributes hold the first step, the "steps" scene extras list the time
+ * and accessors of all steps
+ * @param dataSets Data sets, one per step
+ * @param weld Weld the interface vertices of pieces
+ * @param cellData Cell data, flat cell data is not supported
+ * @param native Parse .vtu files without VTK when possible
+ * @param quantize Quantize the positions, values & indices, the values over
+ * the range of each step
+ * @param gltfFile GLTF file
+ * @return Status
+ */
+bool writeSteps(const std::vector<PVDDataSet> &dataSets, const bool weld,
+                const CellDataMode cellData, const bool native,
+                const bool quantize, const std::string &gltfFile) {
+  if (cellData == CellDataMode::Flat) {
+    Logger::ERROR("Flat cell data is not supported with time steps");
+    return false;
+  }
+
+  ResultModel resultModel;
+  resultModel.quantize = quantize;
+  std::shared_ptr<const VTUGeometry> geometry = nullptr;
+  std::shared_ptr<const ResultGeometry> resultGeometry = nullptr;
+  std::vector<tinygltf::Value> stepsExtras;
+  for (const PVDDataSet &dataSet : dataSets) {
+    auto reader = VTUReader(dataSet.file);
+    reader.setWeld(weld);
+    reader.setCellData(cellData);
+    reader.setNative(native);
+    reader.setGeometry(geometry);
+    if (!reader.read()) {
+      Logger::ERROR("Unable to read VTU file " + dataSet.file);
+      return false;
+    }
+
+    // First step
+    if (!geometry) {
+      geometry = reader.getGeometry();
+      resultGeometry = reader.getResultGeometry();
+    }
+
+    // Fields
+    const std::vector<Result> results = reader.getResults(resultGeometry);
+    std::vector<int> polygonsAccessors;
+    std::vector<int> trianglesAccessors;
+    std::vector<tinygltf::Value> ranges;
+    if (stepsExtras.empty()) {
+      if (!buildModel(results, resultModel))
+        return false;
+      polygonsAccessors = resultModel.polygonsAccessors;
+      trianglesAccessors = resultModel.trianglesAccessors;
+      ranges = resultModel.ranges;
+    } else if (!appendFields(results, resultModel, polygonsAccessors,
+                             trianglesAccessors, ranges)) {
+      return false;
+    }
+
+    std::vector<tinygltf::Value> fieldsExtras;
+    for (size_t i = 0; i < resultModel.names.size(); ++i) {
+      tinygltf::Value::Object fieldExtras = {
+          {"name", tinygltf::Value(resultModel.names.at(i))},
+          {"edges", tinygltf::Value(polygonsAccessors.at(i))},
+          {"faces", tinygltf::Value(trianglesAccessors.at(i))}};
+      if (quantize)
+        fieldExtras["range"] = ranges.at(i);
+      fieldsExtras.push_back(tinygltf::Value(fieldExtras));
+    }
+    stepsExtras.push_back(
+        tinygltf::Value({{"time", tinygltf::Value(dataSet.time)},
+                         {"fields", tinygltf::Value(fieldsExtras)}}));
+  }
+  resultModel.extras["steps"] = tinygltf::Value(stepsExtras);
+
+  return writeModel(resultModel, gltfFile);
+}
@@ -0,0 +1,91 @@
+#include "Polylines.hpp"
+
+/**
+ * Constructor
+ */
+Polylines::Polylines() = default;
+
+/**
+ * Reserve
+ * @param numberOfPolylines Number of polylines
+ * @param numberOfIndices Number of indices
+ */
+void Polylines::reserve(const size_t numberOfPolylines,
+                        const size_t numberOfIndices) {
+  this->m_offsets.reserve(numberOfPolylines + 1);
+  this->m_indices.reserve(numberOfIndices);
+}
+
+/**
+ * Add index, to the current polyline
+ * @param index Index
+ */
+void Polylines::addIndex(const uint index) { this->m_indices.push_back(index); }
+
+/**
+ * End the current polyline
+ */
+void Polylines::endPolyline() {
+  this->m_offsets.push_back((uint)this->m_indices.size());
+}
+
+/**
+ * Number of polylines
+ * @return Size
+ */
+size_t Polylines::size() const { return this->m_offsets.size() - 1; }
+
+/**
+ * Get offsets
+ * @return Offsets, size() + 1
+ */
+const std::vector<uint> &Polylines::getOffsets() const {
+  return this->m_offsets;
+}
+
+/**
+ * Get indices
+ * @return Indices
+ */
+const std::vector<uint> &Polylines::getIndices() const {
+  return this->m_indices;
+}
+
+/**
+ * Get segments
+ * Index pairs of consecutive vertices, polylines are not joined
+ * @return Segments, 2 indices per segment
+ */
+std::vector<uint> Polylines::getSegments() const {
+  // Count
+  size_t numberOfSegments = 0;
+  for (size_t i = 0; i + 1 < this->m_offsets.size(); ++i) {
+    const uint length = this->m_offsets[i + 1] - this->m_offsets[i];
+    numberOfSegments += length ? length - 1 : 0;
+  }
+
+  // Fill
+  std::vector<uint> segments(2 * numberOfSegments);
+  uint *output = segments.data();
+  for (size_t i = 0; i + 1 < this->m_offsets.size(); ++i)
+    for (uint j = this->m_offsets[i]; j + 1 < this->m_offsets[i + 1]; ++j) {
+      *output++ = this->m_indices[j];
+      *output++ = this->m_indices[j + 1];
+    }
+
+  return segments;
+}
+
+/**
+ * Get points
+ * Index of each one point polyline, which has no segment
+ * @return Points
+ */
+std::vector<uint> Polylines::getPoints() const {
+  std::vector<uint> points;
+  for (size_t i = 0; i + 1 < this->m_offsets.size(); ++i)
+    if (this->m_offsets[i + 1] - this->m_offsets[i] == 1)
+      points.push_back(this->m_indices[this->m_offsets[i]]);
+
+  return points;
+}
@@ -0,0 +1,50 @@
+#ifndef _POLYLINES_
+#define _POLYLINES_
+
+#include <cstddef>
+#include <vector>
+
+using uint = unsigned int;
+
+/**
+ * Polylines class
+ * CSR storage, the indices of polyline i are indices[offsets[i],
+ * offsets[i + 1])
+ */
+class Polylines {
+private:
+  // First index of each polyline, then the end
+  std::vector<uint> m_offsets = {0};
+  // Indices
+  std::vector<uint> m_indices;
+
+public:
+  // Constructor
+  Polylines();
+
+  // Reserve
+  void reserve(const size_t, const size_t);
+
+  // Add index, to the current polyline
+  void addIndex(const uint);
+
+  // End the current polyline
+  void endPolyline();
+
+  // Number of polylines
+  size_t size() const;
+
+  // Get offsets
+  const std::vector<uint> &getOffsets() const;
+
+  // Get indices
+  const std::vector<uint> &getIndices() const;
+
+  // Get segments
+  std::vector<uint> getSegments() const;
+
+  // Get points
+  std::vector<uint> getPoints() const;
+};
+
+#endif //_POLYLINES_
@@ -1,113 +1,1245 @@
 #include "Gmsh.hpp"
 
 #include <algorithm>
-#include <fstream>
-#include <iostream>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <type_traits>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "../logger/Logger.hpp"
+#include "../utils/MappedFile.hpp"
+#include "../utils/Scanner.hpp"
 #include "../utils/utils.hpp"
 
+// Smallest chunk parsed by one thread, in bytes
+constexpr size_t minimalChunkSize = 1 << 20;
+
 /**
  * Constructor
  */
 Gmsh::Gmsh() = default;
 
+/**
+ * Collect labels
+ * @param elements Elements
+ * @return Labels, in order of first appearance
+ */
+template <typename ElementT>
+std::vector<uint> collectLabels(const std::vector<ElementT> &elements) {
+  std::vector<uint> labels;
+  std::unordered_set<uint> known;
+
+  std::for_each(elements.begin(), elements.end(),
+                [&labels, &known](const ElementT &element) {
+                  if (known.insert(element.Label()).second)
+                    labels.push_back(element.Label());
+                });
+
+  return labels;
+}
+
+/**
+ * Partition
+ * Counting sort of the elements by label, into CSR offsets
+ * @param elements Elements
+ * @param labels Labels
+ * @return Partition
+ */
+template <typename ElementT>
+Partition partition(const std::vector<ElementT> &elements,
+                    const std::vector<uint> &labels) {
+  Partition partition;
+  partition.labels = labels;
+  partition.offsets.assign(labels.size() + 1, 0);
+  partition.elements.resize(elements.size());
+
+  // Label buckets
+  std::unordered_map<uint, uint> buckets;
+  for (uint i = 0; i < labels.size(); ++i)
+    buckets[labels[i]] = i;
+
+  // Count
+  std::vector<uint> elementBuckets(elements.size());
+  for (size_t i = 0; i < elements.size(); ++i) {
+    const uint bucket = buckets.at(elements[i].Label());
+    elementBuckets[i] = bucket;
+    partition.offsets[bucket + 1]++;
+  }
+
+  // Offsets
+  for (size_t i = 1; i < partition.offsets.size(); ++i)
+    partition.offsets[i] += partition.offsets[i - 1];
+
+  // Scatter
+  std::vector<uint> cursors(partition.offsets.begin(),
+                            partition.offsets.end() - 1);
+  for (size_t i = 0; i < elements.size(); ++i)
+    partition.elements[cursors[elementBuckets[i]]++] = (uint)i;
+
+  return partition;
+}
+
+/**
+ * Find
+ * @param begin Begin
+ * @param end End
+ * @param token Token
+ * @return Token position, or end
+ */
+const char *find(const char *begin, const char *end,
+                 const std::string_view &token) {
+  const char *position = begin;
+  while ((position = (const char *)std::memchr(position, token.front(),
+                                               end - position))) {
+    if ((size_t)(end - position) >= token.size() &&
+        !std::memcmp(position, token.data(), token.size()))
+      return position;
+    position++;
+  }
+
+  return end;
+}
+
+/**
+ * Entity key
+ * @param dimension Entity dimension
+ * @param tag Entity tag
+ * @return Key
+ */
+uint64_t entityKey(const int dimension, const int tag) {
+  return ((uint64_t)(uint)dimension << 32) | (uint)tag;
+}
+
+/**
+ * Is selected
+ * @param groups Selected physical groups, empty for all
+ * @param dimension Element dimension
+ * @param label Element label
+ * @return Status
+ */
+bool isSelected(const std::unordered_set<uint64_t> &groups,
+                const int dimension, const uint label) {
+  return groups.empty() || groups.count(entityKey(dimension, (int)label));
+}
+
+/**
+ * Split lines
+ * Cuts a range into chunks, at line boundaries
+ * @param begin Begin
+ * @param end End
+ * @return Chunk bounds
+ */
+std::vector<const char *> splitLines(const char *begin, const char *end) {
+  const auto size = (size_t)(end - begin);
+  const size_t numberOfChunks =
+      std::max((size_t)1, std::min((size_t)Utils::numberOfThreads(),
+                                   size / minimalChunkSize));
+
+  std::vector<const char *> bounds = {begin};
+  for (size_t chunk = 1; chunk < numberOfChunks; ++chunk) {
+    const char *cut = std::max(begin + size * chunk / numberOfChunks,
+                               bounds.back());
+    const auto *eol = (const char *)std::memchr(cut, '\n', end - cut);
+    bounds.push_back(eol ? eol + 1 : end);
+  }
+  bounds.push_back(end);
+
+  return bounds;
+}
+
+/**
+ * Chunk capacity
+ * Upper estimate of the number of lines in a chunk, from its share of bytes
+ * @param bounds Chunk bounds
+ * @param chunk Chunk
+ * @param numberOfLines Total number of lines
+ * @return Capacity
+ */
+size_t chunkCapacity(const std::vector<const char *> &bounds,
+                     const size_t chunk, const uint numberOfLines) {
+  if (bounds.size() == 2)
+    return numberOfLines;
+
+  const auto size = (double)(bounds.back() - bounds.front());
+  const auto chunkSize = (double)(bounds[chunk + 1] - bounds[chunk]);
+  return (size_t)(1.1 * numberOfLines * chunkSize / size) + 16;
+}
+
+/**
+ * For each line
+ * Blank lines are skipped, the rest of a line after the job is ignored
+ * @param begin Begin
+ * @param end End
+ * @param job Line job, returns false to stop
+ * @return Status
+ */
+template <typename FuncT>
+bool forEachLine(const char *begin, const char *end, FuncT job) {
+  Scanner scanner(begin, end);
+  while (!scanner.eof()) {
+    if (!job(scanner))
+      return false;
+    scanner.skipLine();
+  }
+
+  return true;
+}
+
+/**
+ * Number of corners
+ * Higher order triangles and tetrahedra are reduced to their corners, which
+ * come first
+ * @param type Gmsh element type
+ * @return Number of corners, 0 if the element is not kept
+ */
+uint numberOfCorners(const uint type) {
+  switch (type) {
+  case 2: // 3-nodes triangle
+  case 9: // 6-nodes triangle
+    return 3;
+  case 4:  // 4-nodes tetrahedron
+  case 11: // 10-nodes tetrahedron
+    return 4;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * Is ignored
+ * @param type Gmsh element type
+ * @return True for points and lines, skipped silently
+ */
+bool isIgnored(const uint type) {
+  // 1-node point, 2-nodes line, 3-nodes line
+  return type == 15 || type == 1 || type == 8;
+}
+
+/**
+ * Log unsupported
+ * @param unsupported Number of elements by unsupported type
+ */
+void logUnsupported(const std::map<uint, size_t> &unsupported) {
+  std::for_each(unsupported.begin(), unsupported.end(),
+                [](const std::pair<const uint, size_t> &type) {
+                  Logger::ERROR("Unsupported type: " +
+                                std::to_string(type.first) + " (" +
+                                std::to_string(type.second) + " elements)");
+                });
+}
+
+/**
+ * Elements chunk
+ */
+struct ElementsChunk {
+  uint count = 0;
+  bool status = true;
+  std::vector<Triangle> triangles;
+  std::vector<Tetrahedron> tetrahedra;
+  std::map<uint, size_t> unsupported;
+};
+
+/**
+ * Read element
+ * @param line Line
+ * @param tags Vertex tags
+ * @param groups Selected physical groups
+ * @param chunk Chunk
+ * @return Status
+ */
+bool readElement(Scanner &line, const TagMap &tags,
+                 const std::unordered_set<uint64_t> &groups,
+                 ElementsChunk &chunk) {
+  uint type;
+  uint numberOfLabels;
+  uint label = 0;
+  line.token();
+  if (!line.read(type) || !line.read(numberOfLabels))
+    return false;
+
+  if (numberOfLabels && !line.read(label))
+    return false;
+  for (uint j = 1; j < numberOfLabels; ++j)
+    line.token();
+
+  // The rest of the line is skipped by the caller
+  const uint numberOfElementCorners = numberOfCorners(type);
+  if (!numberOfElementCorners) {
+    if (!isIgnored(type))
+      chunk.unsupported[type]++;
+    return true;
+  }
+  if (!isSelected(groups, numberOfElementCorners - 1, label))
+    return true;
+
+  int indices[4];
+  for (uint j = 0; j < numberOfElementCorners; ++j) {
+    uint tag;
+    if (!line.read(tag) || (indices[j] = tags.find(tag)) < 0)
+      return false;
+  }
+
+  if (numberOfElementCorners == 3) // Triangle
+    chunk.triangles.emplace_back(indices[0], indices[1], indices[2], label);
+  else // Tetrahedron
+    chunk.tetrahedra.emplace_back(indices[0], indices[1], indices[2],
+                                  indices[3], label);
+
+  return true;
+}
+
+/**
+ * Number of nodes
+ * @param type Gmsh element type
+ * @return Number of nodes, 0 if unknown
+ */
+uint numberOfNodes(const uint type) {
+  static const std::vector<uint> nodes = {
+      0,  2, 3, 4,  4,  8,  6,  5,  3,  6,  9,  10, 27, 18, 14, 1,
+      8,  20, 15, 13, 9,  10, 12, 15, 15, 21, 4,  5,  6,  20, 35, 56};
+  return type < nodes.size() ? nodes[type] : 0;
+}
+
+/**
+ * Read binary
+ * @param scanner Scanner
+ * @param value Value
+ * @return Status
+ */
+template <typename T> bool readBinary(Scanner &scanner, T &value) {
+  return scanner.readBytes(&value, sizeof(T));
+}
+
+/**
+ * Read binary
+ * @param scanner Scanner
+ * @param values Values
+ * @param count Count
+ * @return Status
+ */
+template <typename T>
+bool readBinary(Scanner &scanner, std::vector<T> &values, const size_t count) {
+  values.resize(count);
+  return scanner.readBytes(values.data(), count * sizeof(T));
+}
+
+/**
+ * Read value
+ * @param scanner Scanner
+ * @param binary Binary
+ * @param value Value
+ * @return Status
+ */
+template <typename BinaryT, typename T>
+bool readValue(Scanner &scanner, const bool binary, T &value) {
+  if (!binary)
+    return scanner.read(value);
+
+  BinaryT binaryValue;
+  if (!readBinary(scanner, binaryValue))
+    return false;
+  value = (T)binaryValue;
+  return true;
+}
+
 /**
  * Loader
  * @param {string} fileName File name
  * @returns {boolean} Loading status
  */
 bool Gmsh::load(const std::string &fileName) {
-  uint i;
-  uint numberOfVertices;
-  uint numberOfElements;
-  std::string buffer;
-  std::ifstream file;
+  return this->load(fileName, {});
+}
+
+/**
+ * Loader
+ * Elements outside of the selected physical groups are skipped while
+ * parsing, and unreferenced vertices are dropped
+ * @param fileName File name
+ * @param groups Physical group tags or names, empty for all
+ * @return Loading status
+ */
+bool Gmsh::load(const std::string &fileName,
+                const std::vector<std::string> &groups) {
+  MappedFile file;
 
   // Read file
-  file.open(fileName, std::ios::in);
-  if (!file) {
+  if (!file.open(fileName)) {
     Logger::ERROR("Unable to open " + fileName);
     return false;
   }
+  const char *begin = file.data();
+  const char *end = file.data() + file.size();
+
+  // Format, MSH 2 ASCII when absent
+  std::string_view version = "2.2";
+  uint fileType = 0;
+  Scanner scanner(begin, end);
+  if (scanner.token() == "$MeshFormat") {
+    version = scanner.token();
+    scanner.read(fileType);
+  } else {
+    scanner = Scanner(begin, end);
+  }
+
+  // Selection
+  this->m_groups.clear();
+  if (!groups.empty() && !this->selectGroups(begin, end, groups))
+    return false;
+
+  bool status;
+  if (version.substr(0, 2) == "2." && !fileType) {
+    status = this->loadAscii2(scanner, end);
+  } else if (version.substr(0, 2) == "2.") {
+    uint dataSize = 0;
+    scanner.read(dataSize);
+    if (dataSize != sizeof(double)) {
+      Logger::ERROR("Unsupported data size: " + std::to_string(dataSize));
+      return false;
+    }
+    status = this->loadBinary2(scanner);
+  } else if (version == "4.1") {
+    uint dataSize = 0;
+    scanner.read(dataSize);
+    if (fileType && dataSize != sizeof(size_t)) {
+      Logger::ERROR("Unsupported data size: " + std::to_string(dataSize));
+      return false;
+    }
+    status = this->loadMsh4(scanner, end, fileType);
+  } else {
+    Logger::ERROR("Unsupported format: " + std::string(version) + " " +
+                  std::to_string(fileType));
+    return false;
+  }
+  if (!status)
+    return false;
+
+  if (!groups.empty())
+    this->removeUnreferencedVertices();
+
+  // Labels
+  this->m_triangleLabels = collectLabels(this->m_triangles);
+  this->m_tetrahedronLabels = collectLabels(this->m_tetrahedra);
+
+  return true;
+}
+
+/**
+ * Select physical groups
+ * Numbers are physical tags, of surfaces and volumes. Other groups are
+ * looked up in $PhysicalNames.
+ * @param begin Begin of file
+ * @param end End of file
+ * @param groups Physical group tags or names
+ * @return Status
+ */
+bool Gmsh::selectGroups(const char *begin, const char *end,
+                        const std::vector<std::string> &groups) {
+  // Physical names, before $Nodes. Names may contain spaces.
+  std::unordered_multimap<std::string, uint64_t> names;
+  const char *nodes = find(begin, end, "$Nodes");
+  const char *physicalNames = find(begin, nodes, "$PhysicalNames");
+  if (physicalNames != nodes) {
+    Scanner scanner(physicalNames, nodes);
+    uint numberOfNames = 0;
+    scanner.token();
+    scanner.read(numberOfNames);
+    for (uint i = 0; i < numberOfNames; ++i) {
+      int dimension;
+      int tag;
+      if (!scanner.read(dimension) || !scanner.read(tag))
+        break;
+
+      const char *nameBegin = scanner.position();
+      scanner.skipLine();
+      std::string_view name(nameBegin, scanner.position() - nameBegin);
+      const size_t first = name.find('"');
+      const size_t last = name.rfind('"');
+      if (first != std::string_view::npos && last > first)
+        name = name.substr(first + 1, last - first - 1);
+      names.emplace(std::string(name), entityKey(dimension, tag));
+    }
+  }
+
+  for (const std::string &group : groups) {
+    uint tag = 0;
+    const auto [last, error] =
+        std::from_chars(group.data(), group.data() + group.size(), tag);
+    if (error == std::errc() && last == group.data() + group.size()) {
+      this->m_groups.insert(entityKey(2, (int)tag));
+      this->m_groups.insert(entityKey(3, (int)tag));
+      continue;
+    }
+
+    const auto range = names.equal_range(group);
+    if (range.first == range.second) {
+      Logger::ERROR("Unknown physical group " + group);
+      return false;
+    }
+    std::for_each(range.first, range.second,
+                  [this](const std::pair<const std::string, uint64_t> &name) {
+                    this->m_groups.insert(name.second);
+                  });
+  }
+
+  return true;
+}
+
+/**
+ * Remove unreferenced vertices
+ * Vertices keep their relative order
+ */
+void Gmsh::removeUnreferencedVertices() {
+  std::vector<uint> indices(this->m_vertices.size(), 0);
+  std::for_each(this->m_triangles.begin(), this->m_triangles.end(),
+                [&indices](const Triangle &triangle) {
+                  indices[triangle.I1()] = 1;
+                  indices[triangle.I2()] = 1;
+                  indices[triangle.I3()] = 1;
+                });
+  std::for_each(this->m_tetrahedra.begin(), this->m_tetrahedra.end(),
+                [&indices](const Tetrahedron &tetrahedron) {
+                  indices[tetrahedron.I1()] = 1;
+                  indices[tetrahedron.I2()] = 1;
+                  indices[tetrahedron.I3()] = 1;
+                  indices[tetrahedron.I4()] = 1;
+                });
+
+  // Compact, indices[i] becomes the new index of vertex i
+  uint count = 0;
+  for (size_t i = 0; i < this->m_vertices.size(); ++i) {
+    if (!indices[i])
+      continue;
+    this->m_vertices[count] = this->m_vertices[i];
+    indices[i] = count++;
+  }
+  this->m_vertices.resize(count);
+  this->m_vertices.shrink_to_fit();
+
+  std::for_each(this->m_triangles.begin(), this->m_triangles.end(),
+                [&indices](Triangle &triangle) {
+                  triangle.setI1(indices[triangle.I1()]);
+                  triangle.setI2(indices[triangle.I2()]);
+                  triangle.setI3(indices[triangle.I3()]);
+                });
+  std::for_each(this->m_tetrahedra.begin(), this->m_tetrahedra.end(),
+                [&indices](Tetrahedron &tetrahedron) {
+                  tetrahedron.setI1(indices[tetrahedron.I1()]);
+                  tetrahedron.setI2(indices[tetrahedron.I2()]);
+                  tetrahedron.setI3(indices[tetrahedron.I3()]);
+                  tetrahedron.setI4(indices[tetrahedron.I4()]);
+                });
+}
+
+/**
+ * Load MSH 2 ASCII
+ * $Nodes and $Elements are parsed in parallel, by chunks of lines
+ * @param scanner Scanner
+ * @param end End of file
+ * @return Loading status
+ */
+bool Gmsh::loadAscii2(Scanner &scanner, const char *end) {
+  uint numberOfVertices = 0;
+  uint numberOfElements = 0;
 
   // Vertices
-  file >> buffer;
-  while (buffer != "$Nodes" && !file.eof())
-    file >> buffer;
+  scanner.skipTo("$Nodes");
 
-  file >> numberOfVertices;
-  if (!numberOfVertices) {
+  if (!scanner.read(numberOfVertices) || !numberOfVertices) {
     Logger::ERROR("No vertices");
     return false;
   }
+  scanner.skipLine();
+
+  const char *nodesEnd = find(scanner.position(), end, "$EndNodes");
+  TagMap tags;
+  if (!this->readNodes(scanner.position(), nodesEnd, numberOfVertices, tags))
+    return false;
+
+  // Elements
+  scanner = Scanner(nodesEnd, end);
+  scanner.skipTo("$Elements");
+
+  if (!scanner.read(numberOfElements) || !numberOfElements) {
+    Logger::ERROR("No elements");
+    return false;
+  }
+  scanner.skipLine();
+
+  const char *elementsEnd = find(scanner.position(), end, "$EndElements");
+  return this->readElements(scanner.position(), elementsEnd, numberOfElements,
+                            tags);
+}
+
+/**
+ * Load MSH 2 binary
+ * Vertices and element blocks are copied in bulk
+ * @param scanner Scanner
+ * @return Loading status
+ */
+bool Gmsh::loadBinary2(Scanner &scanner) {
+  uint numberOfVertices = 0;
+  uint numberOfElements = 0;
+
+  // Endianness
+  int one = 0;
+  scanner.skipLine();
+  if (!readBinary(scanner, one) || one != 1) {
+    Logger::ERROR("Unsupported endianness");
+    return false;
+  }
+
+  // Vertices
+  scanner.skipTo("$Nodes");
 
-  for (i = 0; i < numberOfVertices; ++i) {
-    double x;
-    double y;
-    double z;
-    file >> buffer >> x >> y >> z;
-    auto vertex = Vertex(x, y, z);
-    this->m_vertices.push_back(vertex);
+  if (!scanner.read(numberOfVertices) || !numberOfVertices) {
+    Logger::ERROR("No vertices");
+    return false;
   }
+  scanner.skipLine();
+
+  TagMap tags;
+  if (!this->readBinaryNodes2(scanner, numberOfVertices, tags))
+    return false;
 
   // Elements
-  file >> buffer;
-  while (buffer != "$Elements" && !file.eof())
-    file >> buffer;
+  scanner.skipTo("$Elements");
+
+  if (!scanner.read(numberOfElements) || !numberOfElements) {
+    Logger::ERROR("No elements");
+    return false;
+  }
+  scanner.skipLine();
+
+  return this->readBinaryElements2(scanner, numberOfElements, tags);
+}
+
+/**
+ * Read binary nodes (MSH 2)
+ * Each vertex is stored as int tag, double x, double y, double z
+ * @param scanner Scanner
+ * @param numberOfVertices Number of vertices
+ * @param tags Vertex tags, filled
+ * @return Status
+ */
+bool Gmsh::readBinaryNodes2(Scanner &scanner, const uint numberOfVertices,
+                            TagMap &tags) {
+  constexpr size_t recordSize = sizeof(int) + 3 * sizeof(double);
+
+  const char *data = scanner.position();
+  if (!scanner.skipBytes((size_t)numberOfVertices * recordSize)) {
+    Logger::ERROR("Unable to read vertices");
+    return false;
+  }
+
+  this->m_vertices.resize(numberOfVertices);
+  std::vector<size_t> vertexTags(numberOfVertices);
+  Vertex *vertices = this->m_vertices.data();
+  const size_t numberOfChunks = Utils::numberOfThreads();
+  Utils::parallelFor(numberOfChunks, [data, vertices, &vertexTags,
+                                      numberOfVertices,
+                                      numberOfChunks](const size_t chunk) {
+    const size_t begin = numberOfVertices * chunk / numberOfChunks;
+    const size_t end = numberOfVertices * (chunk + 1) / numberOfChunks;
+    for (size_t i = begin; i < end; ++i) {
+      int tag;
+      double coordinates[3];
+      std::memcpy(&tag, data + i * recordSize, sizeof(int));
+      std::memcpy(coordinates, data + i * recordSize + sizeof(int),
+                  sizeof(coordinates));
+      vertexTags[i] = (size_t)std::max(tag, 0);
+      vertices[i] = Vertex(coordinates[0], coordinates[1], coordinates[2]);
+    }
+  });
+
+  if (!tags.build(vertexTags)) {
+    Logger::ERROR("Wrong vertex tags");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Read binary elements (MSH 2)
+ * Elements come by blocks of the same type: int type, int number of
+ * elements, int number of tags, then for each element int tag, int tags,
+ * int nodes
+ * @param scanner Scanner
+ * @param numberOfElements Number of elements
+ * @param tags Vertex tags
+ * @return Status
+ */
+bool Gmsh::readBinaryElements2(Scanner &scanner, const uint numberOfElements,
+                               const TagMap &tags) {
+  std::vector<int> data;
+  int indices[4];
+  std::map<uint, size_t> unsupported;
+  uint count = 0;
+  while (count < numberOfElements) {
+    int header[3];
+    if (!readBinary(scanner, header)) {
+      Logger::ERROR("Unable to read elements");
+      return false;
+    }
+    const auto type = (uint)header[0];
+    const auto numberOfBlockElements = (uint)header[1];
+    const auto numberOfLabels = (uint)header[2];
+
+    const uint numberOfElementNodes = numberOfNodes(type);
+    if (!numberOfElementNodes) {
+      Logger::ERROR("Unsupported type: " + std::to_string(type));
+      return false;
+    }
+    const size_t stride = 1 + numberOfLabels + numberOfElementNodes;
+
+    if (!numberOfBlockElements ||
+        numberOfBlockElements > numberOfElements - count) {
+      Logger::ERROR("Unable to read elements");
+      return false;
+    }
+    count += numberOfBlockElements;
+
+    // Skipped block
+    const uint numberOfElementCorners = numberOfCorners(type);
+    if (!numberOfElementCorners) {
+      if (!isIgnored(type))
+        unsupported[type] += numberOfBlockElements;
+      if (!scanner.skipBytes(numberOfBlockElements * stride * sizeof(int))) {
+        Logger::ERROR("Unable to read elements");
+        return false;
+      }
+      continue;
+    }
+
+    if (!readBinary(scanner, data, numberOfBlockElements * stride)) {
+      Logger::ERROR("Unable to read elements");
+      return false;
+    }
+
+    for (size_t i = 0; i < numberOfBlockElements; ++i) {
+      const int *element = data.data() + stride * i;
+      const uint label = numberOfLabels ? (uint)element[1] : 0;
+      if (!isSelected(this->m_groups, numberOfElementCorners - 1, label))
+        continue;
+
+      const int *nodes = element + 1 + numberOfLabels;
+      for (uint j = 0; j < numberOfElementCorners; ++j)
+        if (nodes[j] < 1 || (indices[j] = tags.find((size_t)nodes[j])) < 0) {
+          Logger::ERROR("Wrong vertex tag: " + std::to_string(nodes[j]));
+          return false;
+        }
+
+      if (numberOfElementCorners == 3) // Triangle
+        this->m_triangles.emplace_back(indices[0], indices[1], indices[2],
+                                       label);
+      else // Tetrahedron
+        this->m_tetrahedra.emplace_back(indices[0], indices[1], indices[2],
+                                        indices[3], label);
+    }
+  }
+  logUnsupported(unsupported);
+
+  return true;
+}
+
+/**
+ * Read nodes
+ * @param begin Begin of the node lines
+ * @param end End of the node lines
+ * @param numberOfVertices Number of vertices
+ * @param tags Vertex tags, filled
+ * @return Status
+ */
+bool Gmsh::readNodes(const char *begin, const char *end,
+                     const uint numberOfVertices, TagMap &tags) {
+  const std::vector<const char *> bounds = splitLines(begin, end);
+  const size_t numberOfChunks = bounds.size() - 1;
+
+  std::vector<std::vector<Vertex>> chunks(numberOfChunks);
+  std::vector<std::vector<size_t>> tagChunks(numberOfChunks);
+  std::vector<char> status(numberOfChunks, 1);
+  Utils::parallelFor(numberOfChunks, [&bounds, numberOfVertices, &chunks,
+                                      &tagChunks,
+                                      &status](const size_t chunk) {
+    std::vector<Vertex> &vertices = chunks[chunk];
+    std::vector<size_t> &vertexTags = tagChunks[chunk];
+    const size_t capacity = chunkCapacity(bounds, chunk, numberOfVertices);
+    vertices.reserve(capacity);
+    vertexTags.reserve(capacity);
+
+    status[chunk] = forEachLine(bounds[chunk], bounds[chunk + 1],
+                                [&vertices, &vertexTags](Scanner &line) {
+                                  uint tag;
+                                  double x;
+                                  double y;
+                                  double z;
+                                  if (!line.read(tag) || !line.read(x) ||
+                                      !line.read(y) || !line.read(z))
+                                    return false;
+                                  vertexTags.push_back(tag);
+                                  vertices.emplace_back(x, y, z);
+                                  return true;
+                                });
+  });
+
+  // Merge
+  size_t count = 0;
+  for (size_t chunk = 0; chunk < numberOfChunks; ++chunk) {
+    if (!status[chunk]) {
+      Logger::ERROR("Unable to read vertices");
+      return false;
+    }
+    count += chunks[chunk].size();
+  }
+  if (count != numberOfVertices) {
+    Logger::ERROR("Wrong number of vertices: " + std::to_string(count) +
+                  " instead of " + std::to_string(numberOfVertices));
+    return false;
+  }
+
+  std::vector<size_t> vertexTags;
+  if (numberOfChunks == 1 && this->m_vertices.empty()) {
+    this->m_vertices = std::move(chunks.front());
+    vertexTags = std::move(tagChunks.front());
+  } else {
+    this->m_vertices.reserve(this->m_vertices.size() + count);
+    vertexTags.reserve(count);
+    for (size_t chunk = 0; chunk < numberOfChunks; ++chunk) {
+      this->m_vertices.insert(this->m_vertices.end(), chunks[chunk].begin(),
+                              chunks[chunk].end());
+      vertexTags.insert(vertexTags.end(), tagChunks[chunk].begin(),
+                        tagChunks[chunk].end());
+    }
+  }
+
+  if (!tags.build(vertexTags)) {
+    Logger::ERROR("Wrong vertex tags");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Read elements
+ * @param begin Begin of the element lines
+ * @param end End of the element lines
+ * @param numberOfElements Number of elements
+ * @param tags Vertex tags
+ * @return Status
+ */
+bool Gmsh::readElements(const char *begin, const char *end,
+                        const uint numberOfElements, const TagMap &tags) {
+  const std::vector<const char *> bounds = splitLines(begin, end);
+  const size_t numberOfChunks = bounds.size() - 1;
+
+  std::vector<ElementsChunk> chunks(numberOfChunks);
+  Utils::parallelFor(numberOfChunks, [this, &bounds, &tags,
+                                      &chunks](const size_t chunk) {
+    ElementsChunk &elements = chunks[chunk];
+    elements.status = forEachLine(bounds[chunk], bounds[chunk + 1],
+                                  [this, &tags, &elements](Scanner &line) {
+                                    elements.count++;
+                                    return readElement(line, tags,
+                                                       this->m_groups,
+                                                       elements);
+                                  });
+  });
+
+  // Merge
+  size_t count = 0;
+  size_t numberOfTriangles = 0;
+  size_t numberOfTetrahedra = 0;
+  for (const ElementsChunk &elements : chunks) {
+    if (!elements.status) {
+      Logger::ERROR("Unable to read elements");
+      return false;
+    }
+    count += elements.count;
+    numberOfTriangles += elements.triangles.size();
+    numberOfTetrahedra += elements.tetrahedra.size();
+  }
+  if (count != numberOfElements) {
+    Logger::ERROR("Wrong number of elements: " + std::to_string(count) +
+                  " instead of " + std::to_string(numberOfElements));
+    return false;
+  }
+
+  if (numberOfChunks == 1 && this->m_triangles.empty() &&
+      this->m_tetrahedra.empty()) {
+    this->m_triangles = std::move(chunks.front().triangles);
+    this->m_tetrahedra = std::move(chunks.front().tetrahedra);
+
+    // Grown on demand, the spare capacity is released
+    this->m_triangles.shrink_to_fit();
+    this->m_tetrahedra.shrink_to_fit();
+  } else {
+    this->m_triangles.reserve(this->m_triangles.size() + numberOfTriangles);
+    this->m_tetrahedra.reserve(this->m_tetrahedra.size() + numberOfTetrahedra);
+    std::for_each(chunks.begin(), chunks.end(),
+                  [this](const ElementsChunk &elements) {
+                    this->m_triangles.insert(this->m_triangles.end(),
+                                             elements.triangles.begin(),
+                                             elements.triangles.end());
+                    this->m_tetrahedra.insert(this->m_tetrahedra.end(),
+                                              elements.tetrahedra.begin(),
+                                              elements.tetrahedra.end());
+                  });
+  }
+
+  // Unsupported
+  std::map<uint, size_t> unsupported;
+  std::for_each(chunks.begin(), chunks.end(),
+                [&unsupported](const ElementsChunk &elements) {
+                  for (const auto &[type, count] : elements.unsupported)
+                    unsupported[type] += count;
+                });
+  logUnsupported(unsupported);
+
+  return true;
+}
+
+/**
+ * Read entities (MSH 4.1)
+ * @param scanner Scanner
+ * @param binary Binary
+ * @param physicals First physical tag of each entity
+ * @return Status
+ */
+bool readEntities4(Scanner &scanner, const bool binary,
+                   std::unordered_map<uint64_t, uint> &physicals) {
+  uint numbers[4];
+  for (uint &number : numbers)
+    if (!readValue<size_t>(scanner, binary, number))
+      return false;
+
+  for (int dimension = 0; dimension < 4; ++dimension) {
+    for (uint i = 0; i < numbers[dimension]; ++i) {
+      int tag;
+      uint numberOfPhysicals;
+      double coordinate;
+      if (!readValue<int>(scanner, binary, tag))
+        return false;
+
+      // Point coordinates, or bounding box
+      for (int j = 0; j < (dimension ? 6 : 3); ++j)
+        if (!readValue<double>(scanner, binary, coordinate))
+          return false;
 
-  file >> numberOfElements;
+      // Physical tags
+      if (!readValue<size_t>(scanner, binary, numberOfPhysicals))
+        return false;
+      for (uint j = 0; j < numberOfPhysicals; ++j) {
+        int physical;
+        if (!readValue<int>(scanner, binary, physical))
+          return false;
+        if (!j)
+          physicals[entityKey(dimension, tag)] = (uint)std::abs(physical);
+      }
+
+      // Bounding entities
+      if (dimension) {
+        uint numberOfBoundings;
+        if (!readValue<size_t>(scanner, binary, numberOfBoundings))
+          return false;
+        for (uint j = 0; j < numberOfBoundings; ++j) {
+          int bounding;
+          if (!readValue<int>(scanner, binary, bounding))
+            return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Load MSH 4.1
+ * Sections are read entity block by entity block. Binary blocks are copied
+ * in bulk. An element gets the first physical tag of its entity as label, 0
+ * if there is none.
+ * @param scanner Scanner
+ * @param end End of file
+ * @param binary Binary
+ * @return Loading status
+ */
+bool Gmsh::loadMsh4(Scanner &scanner, const char *end, const bool binary) {
+  // Endianness
+  if (binary) {
+    int one = 0;
+    scanner.skipLine();
+    if (!readBinary(scanner, one) || one != 1) {
+      Logger::ERROR("Unsupported endianness");
+      return false;
+    }
+  }
+  if (!scanner.skipTo("$EndMeshFormat")) {
+    Logger::ERROR("Missing $EndMeshFormat");
+    return false;
+  }
+
+  std::unordered_map<uint64_t, uint> physicals;
+  TagMap tags;
+  bool hasNodes = false;
+  bool hasElements = false;
+
+  while (!scanner.eof()) {
+    const std::string_view section = scanner.token();
+    if (section.empty() || section.front() != '$') {
+      Logger::ERROR("Unexpected token: " + std::string(section));
+      return false;
+    }
+    if (binary)
+      scanner.skipLine();
+
+    bool status = true;
+    if (section == "$Entities") {
+      status = readEntities4(scanner, binary, physicals);
+    } else if (section == "$Nodes") {
+      status = this->readNodes4(scanner, binary, tags);
+      hasNodes = true;
+    } else if (section == "$Elements") {
+      status = this->readElements4(scanner, binary, tags, physicals);
+      hasElements = true;
+    }
+    if (!status)
+      return false;
+
+    // Section end
+    const std::string sectionEnd = "$End" + std::string(section.substr(1));
+    const char *position =
+        find(scanner.position(), end, std::string_view(sectionEnd));
+    if (position == end) {
+      Logger::ERROR("Missing " + sectionEnd);
+      return false;
+    }
+    scanner = Scanner(position + sectionEnd.size(), end);
+  }
+
+  if (!hasNodes || this->m_vertices.empty()) {
+    Logger::ERROR("No vertices");
+    return false;
+  }
+  if (!hasElements) {
+    Logger::ERROR("No elements");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Read nodes (MSH 4.1)
+ * Vertices are stored in file order
+ * @param scanner Scanner
+ * @param binary Binary
+ * @param tags Vertex tags, filled
+ * @return Status
+ */
+bool Gmsh::readNodes4(Scanner &scanner, const bool binary, TagMap &tags) {
+  static_assert(std::is_trivially_copyable_v<Vertex> &&
+                    sizeof(Vertex) == 3 * sizeof(double),
+                "Vertex must be 3 packed doubles");
+
+  uint numberOfBlocks;
+  uint numberOfVertices;
+  uint tag;
+  if (!readValue<size_t>(scanner, binary, numberOfBlocks) ||
+      !readValue<size_t>(scanner, binary, numberOfVertices) ||
+      !readValue<size_t>(scanner, binary, tag) ||
+      !readValue<size_t>(scanner, binary, tag)) {
+    Logger::ERROR("Unable to read vertices");
+    return false;
+  }
+  if (!numberOfVertices) {
+    Logger::ERROR("No vertices");
+    return false;
+  }
+  this->m_vertices.reserve(numberOfVertices);
+
+  std::vector<size_t> vertexTags;
+  vertexTags.reserve(numberOfVertices);
+  std::vector<size_t> blockTags;
+  std::vector<double> coordinates;
+  for (uint block = 0; block < numberOfBlocks; ++block) {
+    int dimension;
+    int entity;
+    int parametric;
+    uint numberOfBlockVertices;
+    if (!readValue<int>(scanner, binary, dimension) ||
+        !readValue<int>(scanner, binary, entity) ||
+        !readValue<int>(scanner, binary, parametric) ||
+        !readValue<size_t>(scanner, binary, numberOfBlockVertices)) {
+      Logger::ERROR("Unable to read vertices");
+      return false;
+    }
+    const size_t stride = 3 + (parametric ? dimension : 0);
+
+    // Tags
+    bool status = true;
+    if (binary) {
+      status = readBinary(scanner, blockTags, numberOfBlockVertices);
+    } else {
+      blockTags.resize(numberOfBlockVertices);
+      for (size_t &vertexTag : blockTags) {
+        uint value = 0;
+        status = status && scanner.read(value);
+        vertexTag = value;
+      }
+    }
+    if (!status) {
+      Logger::ERROR("Unable to read vertex tags");
+      return false;
+    }
+    vertexTags.insert(vertexTags.end(), blockTags.begin(), blockTags.end());
+
+    // Coordinates
+    const size_t first = this->m_vertices.size();
+    if (binary && stride == 3) {
+      this->m_vertices.resize(first + blockTags.size());
+      status = scanner.readBytes(this->m_vertices.data() + first,
+                                 blockTags.size() * sizeof(Vertex));
+    } else if (binary) {
+      status = readBinary(scanner, coordinates, blockTags.size() * stride);
+    } else {
+      coordinates.resize(blockTags.size() * stride);
+      for (double &coordinate : coordinates)
+        status = status && scanner.read(coordinate);
+    }
+    if (!status) {
+      Logger::ERROR("Unable to read vertices");
+      return false;
+    }
+
+    if (!binary || stride != 3)
+      for (size_t i = 0; i < blockTags.size(); ++i)
+        this->m_vertices.emplace_back(coordinates[stride * i + 0],
+                                      coordinates[stride * i + 1],
+                                      coordinates[stride * i + 2]);
+  }
+
+  if (!tags.build(vertexTags)) {
+    Logger::ERROR("Wrong vertex tags");
+    return false;
+  }
+
+  return true;
+}
+
+/**
+ * Read elements (MSH 4.1)
+ * @param scanner Scanner
+ * @param binary Binary
+ * @param tags Vertex tags
+ * @param physicals First physical tag of each entity
+ * @return Status
+ */
+bool Gmsh::readElements4(
+    Scanner &scanner, const bool binary, const TagMap &tags,
+    const std::unordered_map<uint64_t, uint> &physicals) {
+  uint numberOfBlocks;
+  uint numberOfElements;
+  uint tag;
+  if (!readValue<size_t>(scanner, binary, numberOfBlocks) ||
+      !readValue<size_t>(scanner, binary, numberOfElements) ||
+      !readValue<size_t>(scanner, binary, tag) ||
+      !readValue<size_t>(scanner, binary, tag)) {
+    Logger::ERROR("Unable to read elements");
+    return false;
+  }
   if (!numberOfElements) {
     Logger::ERROR("No elements");
     return false;
   }
 
-  for (i = 0; i < numberOfElements; ++i) {
+  std::vector<size_t> data;
+  int indices[4];
+  std::map<uint, size_t> unsupported;
+  for (uint block = 0; block < numberOfBlocks; ++block) {
+    int dimension;
+    int entity;
     uint type;
-    uint numberOfLabels;
-    uint label;
-    file >> buffer >> type >> numberOfLabels;
-
-    file >> label >> buffer;
-    for (uint j = 2; j < numberOfLabels; ++j)
-      file >> buffer;
-
-    if (type == 2) { // 3-nodes triangle
-      uint index1;
-      uint index2;
-      uint index3;
-      file >> index1 >> index2 >> index3;
-      auto triangle = Triangle(--index1, --index2, --index3, label);
-      this->m_triangles.push_back(triangle);
-      if (std::find(this->m_triangleLabels.begin(),
-                    this->m_triangleLabels.end(),
-                    label) == this->m_triangleLabels.end())
-        this->m_triangleLabels.push_back(label);
-    } else if (type == 4) { // 4-nodes tetrahedron
-      uint index1;
-      uint index2;
-      uint index3;
-      uint index4;
-      file >> index1 >> index2 >> index3 >> index4;
-      auto tetrahedron =
-          Tetrahedron(--index1, --index2, --index3, --index4, label);
-      this->m_tetrahedra.push_back(tetrahedron);
-      if (std::find(this->m_tetrahedronLabels.begin(),
-                    this->m_tetrahedronLabels.end(),
-                    label) == this->m_tetrahedronLabels.end())
-        this->m_tetrahedronLabels.push_back(label);
-    } else if (type == 15) { // 1-node point
-      uint index1;
-      file >> index1;
-    } else if (type == 1) { // 2-node line
-      uint index1;
-      uint index2;
-      file >> index1 >> index2;
-    } else {
-      Logger::ERROR("Unsupported type: " + std::to_string(type));
+    uint numberOfBlockElements;
+    if (!readValue<int>(scanner, binary, dimension) ||
+        !readValue<int>(scanner, binary, entity) ||
+        !readValue<int>(scanner, binary, type) ||
+        !readValue<size_t>(scanner, binary, numberOfBlockElements)) {
+      Logger::ERROR("Unable to read elements");
+      return false;
+    }
+
+    const auto physical = physicals.find(entityKey(dimension, entity));
+    const uint label = physical == physicals.end() ? 0 : physical->second;
+
+    // Element tag + node tags
+    const uint numberOfElementNodes = numberOfNodes(type);
+    const size_t stride = 1 + numberOfElementNodes;
+
+    // Skipped block, one element per line in ASCII
+    const uint numberOfElementCorners = numberOfCorners(type);
+    if (!numberOfElementCorners ||
+        !isSelected(this->m_groups, dimension, label)) {
+      if (!numberOfElementCorners && !isIgnored(type))
+        unsupported[type] += numberOfBlockElements;
+
+      bool status = true;
+      if (binary) {
+        status = numberOfElementNodes &&
+                 scanner.skipBytes(numberOfBlockElements * stride *
+                                   sizeof(size_t));
+      } else {
+        scanner.skipLine();
+        for (uint i = 0; i < numberOfBlockElements; ++i)
+          scanner.skipLine();
+      }
+      if (!status) {
+        Logger::ERROR("Unable to read elements of type " +
+                      std::to_string(type));
+        return false;
+      }
       continue;
     }
+
+    bool status = true;
+    if (binary) {
+      status = readBinary(scanner, data, numberOfBlockElements * stride);
+    } else {
+      data.resize(numberOfBlockElements * stride);
+      for (size_t &value : data) {
+        uint nodeTag = 0;
+        status = status && scanner.read(nodeTag);
+        value = nodeTag;
+      }
+    }
+    if (!status) {
+      Logger::ERROR("Unable to read elements");
+      return false;
+    }
+
+    for (size_t i = 0; i < numberOfBlockElements; ++i) {
+      const size_t *nodes = data.data() + stride * i + 1;
+      for (uint j = 0; j < numberOfElementCorners; ++j)
+        if ((indices[j] = tags.find(nodes[j])) < 0) {
+          Logger::ERROR("Wrong vertex tag: " + std::to_string(nodes[j]));
+          return false;
+        }
+
+      if (numberOfElementCorners == 3) // Triangle
+        this->m_triangles.emplace_back(indices[0], indices[1], indices[2],
+                                       label);
+      else // Tetrahedron
+        this->m_tetrahedra.emplace_back(indices[0], indices[1], indices[2],
+                                        indices[3], label);
+    }
   }
+  logUnsupported(unsupported);
 
   return true;
 }
@@ -119,6 +1251,13 @@ std::vector<uint> Gmsh::getSurfaceLabels() const {
   return this->m_triangleLabels;
 }
 
+/**
+ * Get volume labels
+ */
+std::vector<uint> Gmsh::getVolumeLabels() const {
+  return this->m_tetrahedronLabels;
+}
+
 /**
  * Index job
  * @param index Index
@@ -129,76 +1268,369 @@ std::vector<uint> Gmsh::getSurfaceLabels() const {
  */
 template <typename FuncT>
 void indexJob(const uint index, const std::vector<Vertex> &originalVertices,
-              std::vector<Vertex> &vertices,
-              std::vector<std::pair<uint, uint>> &indices, FuncT set) {
-  auto find = Utils::findIndex(index, indices);
-  if (find == -1) {
-    const auto newIndex = (uint)vertices.size();
+              std::vector<Vertex> &vertices, IndexMap &indices, FuncT set) {
+  bool inserted;
+  const uint newIndex = indices.insert(index, inserted);
+  if (inserted)
     vertices.push_back(originalVertices.at(index));
-    set(newIndex);
-    indices.push_back({index, newIndex});
-  } else {
-    set(find);
-  }
+  set(newIndex);
 }
 
 /**
- * Get surface
+ * Partition triangles
+ * @return Partition
+ */
+Partition Gmsh::partitionTriangles() const {
+  return partition(this->m_triangles, this->m_triangleLabels);
+}
+
+/**
+ * Partition tetrahedra
+ * @return Partition
+ */
+Partition Gmsh::partitionTetrahedra() const {
+  return partition(this->m_tetrahedra, this->m_tetrahedronLabels);
+}
+
+/**
+ * Make surface
  * @param label Label
+ * @param originalTriangles Triangles
+ * @param begin First triangle id
+ * @param end Past the end triangle id
+ * @param indices Index map
  * @return Surface
  */
-Surface Gmsh::getSurface(const uint label) const {
-  // Surface triangles & vertices
-  std::vector<Triangle> tempTriangles;
-  std::vector<Triangle> triangles;
+Surface Gmsh::makeSurface(const uint label,
+                          const std::vector<Triangle> &originalTriangles,
+                          std::vector<uint>::const_iterator begin,
+                          std::vector<uint>::const_iterator end,
+                          IndexMap &indices) const {
   std::vector<Vertex> vertices;
 
+  indices.reserve((uint)this->m_vertices.size());
+  indices.clear();
+
+  Surface surface = this->makeSurface(label, originalTriangles, begin, end,
+                                      indices, vertices);
+
+  // min / max
+  std::vector<Vertex> minMaxVertex = Utils::minMax(vertices);
+
+  surface.minVertex = minMaxVertex.at(0);
+  surface.maxVertex = minMaxVertex.at(1);
+  surface.vertices = std::move(vertices);
+
+  return surface;
+}
+
+/**
+ * Make surface
+ * New vertices are appended, the index map is not cleared
+ * @param label Label
+ * @param originalTriangles Triangles
+ * @param begin First triangle id
+ * @param end Past the end triangle id
+ * @param indices Index map
+ * @param vertices Vertices
+ * @return Surface, without vertices
+ */
+Surface Gmsh::makeSurface(const uint label,
+                          const std::vector<Triangle> &originalTriangles,
+                          std::vector<uint>::const_iterator begin,
+                          std::vector<uint>::const_iterator end,
+                          IndexMap &indices,
+                          std::vector<Vertex> &vertices) const {
   // Surface triangles
-  std::for_each(this->m_triangles.begin(), this->m_triangles.end(),
-                [label, &tempTriangles](const Triangle triangle) {
-                  if (triangle.Label() == label) {
-                    tempTriangles.push_back(triangle);
-                  }
-                });
+  std::vector<Triangle> triangles;
+  triangles.reserve(end - begin);
 
-  // Surface vertices
-  std::vector<std::pair<uint, uint>> newIndices;
-  std::for_each(
-      tempTriangles.begin(), tempTriangles.end(),
-      [this, &vertices, &newIndices, &triangles](const Triangle triangle) {
-        const uint index1 = triangle.I1();
-        const uint index2 = triangle.I2();
-        const uint index3 = triangle.I3();
+  indices.reserve((uint)this->m_vertices.size());
 
-        Triangle newTriangle;
+  std::for_each(begin, end,
+                [this, &originalTriangles, &vertices, &indices,
+                 &triangles](const uint id) {
+                  const Triangle &triangle = originalTriangles[id];
+                  const uint index1 = triangle.I1();
+                  const uint index2 = triangle.I2();
+                  const uint index3 = triangle.I3();
 
-        indexJob(
-            index1, this->m_vertices, vertices, newIndices,
-            [&newTriangle](const uint index) { newTriangle.setI1(index); });
+                  Triangle newTriangle;
 
-        indexJob(
-            index2, this->m_vertices, vertices, newIndices,
-            [&newTriangle](const uint index) { newTriangle.setI2(index); });
+                  indexJob(index1, this->m_vertices, vertices, indices,
+                           [&newTriangle](const uint index) {
+                             newTriangle.setI1(index);
+                           });
 
-        indexJob(
-            index3, this->m_vertices, vertices, newIndices,
-            [&newTriangle](const uint index) { newTriangle.setI3(index); });
+                  indexJob(index2, this->m_vertices, vertices, indices,
+                           [&newTriangle](const uint index) {
+                             newTriangle.setI2(index);
+                           });
 
-        triangles.push_back(newTriangle);
-      });
+                  indexJob(index3, this->m_vertices, vertices, indices,
+                           [&newTriangle](const uint index) {
+                             newTriangle.setI3(index);
+                           });
+
+                  triangles.push_back(newTriangle);
+                });
 
   // min / max
   std::vector<uint> minMaxIndex = Utils::minMax(triangles);
-  std::vector<Vertex> minMaxVertex = Utils::minMax(vertices);
 
   Surface surface;
   surface.label = label;
   surface.minIndex = minMaxIndex.at(0);
   surface.maxIndex = minMaxIndex.at(1);
-  surface.minVertex = minMaxVertex.at(0);
-  surface.maxVertex = minMaxVertex.at(1);
-  surface.triangles = triangles;
-  surface.vertices = vertices;
+  surface.triangles = std::move(triangles);
 
   return surface;
 }
+
+/**
+ * Get surface
+ * @param label Label
+ * @return Surface
+ */
+Surface Gmsh::getSurface(const uint label) const {
+  IndexMap indices;
+  return this->getSurface(label, indices);
+}
+
+/**
+ * Get surface
+ * @param label Label
+ * @param indices Index map, reused between calls
+ * @return Surface
+ */
+Surface Gmsh::getSurface(const uint label, IndexMap &indices) const {
+  std::vector<uint> ids;
+  for (uint i = 0; i < this->m_triangles.size(); ++i)
+    if (this->m_triangles[i].Label() == label)
+      ids.push_back(i);
+
+  return this->makeSurface(label, this->m_triangles, ids.cbegin(), ids.cend(),
+                           indices);
+}
+
+/**
+ * Get surface
+ * @param partition Triangles partition
+ * @param bucket Bucket
+ * @param indices Index map, reused between calls
+ * @return Surface
+ */
+Surface Gmsh::getSurface(const Partition &partition, const uint bucket,
+                         IndexMap &indices) const {
+  return this->makeSurface(
+      partition.labels.at(bucket), this->m_triangles,
+      partition.elements.cbegin() + partition.offsets.at(bucket),
+      partition.elements.cbegin() + partition.offsets.at(bucket + 1), indices);
+}
+
+/**
+ * Get surface
+ * @param partition Triangles partition
+ * @param bucket Bucket
+ * @param indices Index map, shared between calls
+ * @param vertices Vertices, shared between calls
+ * @return Surface, indexed in the shared vertices
+ */
+Surface Gmsh::getSurface(const Partition &partition, const uint bucket,
+                         IndexMap &indices,
+                         std::vector<Vertex> &vertices) const {
+  return this->makeSurface(
+      partition.labels.at(bucket), this->m_triangles,
+      partition.elements.cbegin() + partition.offsets.at(bucket),
+      partition.elements.cbegin() + partition.offsets.at(bucket + 1), indices,
+      vertices);
+}
+
+/**
+ * Get surfaces
+ * @return Surfaces, in surface labels order
+ */
+std::vector<Surface> Gmsh::getSurfaces() const {
+  const Partition partition = this->partitionTriangles();
+
+  std::vector<Surface> surfaces;
+  surfaces.reserve(partition.labels.size());
+
+  IndexMap indices((uint)this->m_vertices.size());
+  for (uint bucket = 0; bucket < partition.labels.size(); ++bucket)
+    surfaces.push_back(this->getSurface(partition, bucket, indices));
+
+  return surfaces;
+}
+
+/**
+ * Make volume
+ * @param label Label
+ * @param begin First tetrahedron id
+ * @param end Past the end tetrahedron id
+ * @param indices Index map
+ * @return Volume
+ */
+Volume Gmsh::makeVolume(const uint label,
+                        std::vector<uint>::const_iterator begin,
+                        std::vector<uint>::const_iterator end,
+                        IndexMap &indices) const {
+  // Volume tetrahedra & vertices
+  std::vector<Tetrahedron> tetrahedra;
+  std::vector<Vertex> vertices;
+  tetrahedra.reserve(end - begin);
+
+  indices.reserve((uint)this->m_vertices.size());
+  indices.clear();
+
+  std::for_each(
+      begin, end,
+      [this, label, &vertices, &indices, &tetrahedra](const uint id) {
+        const Tetrahedron &tetrahedron = this->m_tetrahedra[id];
+
+        Tetrahedron newTetrahedron;
+        newTetrahedron.setLabel(label);
+
+        indexJob(tetrahedron.I1(), this->m_vertices, vertices, indices,
+                 [&newTetrahedron](const uint index) {
+                   newTetrahedron.setI1(index);
+                 });
+
+        indexJob(tetrahedron.I2(), this->m_vertices, vertices, indices,
+                 [&newTetrahedron](const uint index) {
+                   newTetrahedron.setI2(index);
+                 });
+
+        indexJob(tetrahedron.I3(), this->m_vertices, vertices, indices,
+                 [&newTetrahedron](const uint index) {
+                   newTetrahedron.setI3(index);
+                 });
+
+        indexJob(tetrahedron.I4(), this->m_vertices, vertices, indices,
+                 [&newTetrahedron](const uint index) {
+                   newTetrahedron.setI4(index);
+                 });
+
+        tetrahedra.push_back(newTetrahedron);
+      });
+
+  // min / max
+  std::vector<uint> minMaxIndex = Utils::minMax(tetrahedra);
+  std::vector<Vertex> minMaxVertex = Utils::minMax(vertices);
+
+  Volume volume;
+  volume.label = label;
+  volume.minIndex = minMaxIndex.at(0);
+  volume.maxIndex = minMaxIndex.at(1);
+  volume.minVertex = minMaxVertex.at(0);
+  volume.maxVertex = minMaxVertex.at(1);
+  volume.tetrahedra = std::move(tetrahedra);
+  volume.vertices = std::move(vertices);
+
+  return volume;
+}
+
+/**
+ * Get volume
+ * @param label Label
+ * @return Volume
+ */
+Volume Gmsh::getVolume(const uint label) const {
+  std::vector<uint> ids;
+  for (uint i = 0; i < this->m_tetrahedra.size(); ++i)
+    if (this->m_tetrahedra[i].Label() == label)
+      ids.push_back(i);
+
+  IndexMap indices;
+  return this->makeVolume(label, ids.cbegin(), ids.cend(), indices);
+}
+
+/**
+ * Get volume
+ * @param partition Tetrahedra partition
+ * @param bucket Bucket
+ * @param indices Index map, reused between calls
+ * @return Volume
+ */
+Volume Gmsh::getVolume(const Partition &partition, const uint bucket,
+                       IndexMap &indices) const {
+  return this->makeVolume(
+      partition.labels.at(bucket),
+      partition.elements.cbegin() + partition.offsets.at(bucket),
+      partition.elements.cbegin() + partition.offsets.at(bucket + 1), indices);
+}
+
+/**
+ * Make skin
+ * @param label Label
+ * @param begin First tetrahedron id
+ * @param end Past the end tetrahedron id
+ * @param indices Index map
+ * @param vertices Shared vertices, nullptr for own vertices
+ * @return Boundary surface
+ */
+Surface Gmsh::makeSkin(const uint label,
+                       std::vector<uint>::const_iterator begin,
+                       std::vector<uint>::const_iterator end,
+                       IndexMap &indices,
+                       std::vector<Vertex> *vertices) const {
+  const std::vector<Triangle> triangles =
+      Utils::skin(this->m_tetrahedra, this->m_vertices, begin, end);
+
+  std::vector<uint> ids(triangles.size());
+  std::iota(ids.begin(), ids.end(), 0);
+
+  if (vertices)
+    return this->makeSurface(label, triangles, ids.cbegin(), ids.cend(),
+                             indices, *vertices);
+  return this->makeSurface(label, triangles, ids.cbegin(), ids.cend(),
+                           indices);
+}
+
+/**
+ * Get skin
+ * @param label Volume label
+ * @return Boundary surface of the volume
+ */
+Surface Gmsh::getSkin(const uint label) const {
+  std::vector<uint> ids;
+  for (uint i = 0; i < this->m_tetrahedra.size(); ++i)
+    if (this->m_tetrahedra[i].Label() == label)
+      ids.push_back(i);
+
+  IndexMap indices;
+  return this->makeSkin(label, ids.cbegin(), ids.cend(), indices, nullptr);
+}
+
+/**
+ * Get skin
+ * @param partition Tetrahedra partition
+ * @param bucket Bucket
+ * @param indices Index map, reused between calls
+ * @return Boundary surface of the volume
+ */
+Surface Gmsh::getSkin(const Partition &partition, const uint bucket,
+                      IndexMap &indices) const {
+  return this->makeSkin(
+      partition.labels.at(bucket),
+      partition.elements.cbegin() + partition.offsets.at(bucket),
+      partition.elements.cbegin() + partition.offsets.at(bucket + 1), indices,
+      nullptr);
+}
+
+/**
+ * Get skin
+ * @param partition Tetrahedra partition
+ * @param bucket Bucket
+ * @param indices Index map, shared between calls
+ * @param vertices Vertices, shared between calls
+ * @return Boundary surface of the volume, indexed in the shared vertices
+ */
+Surface Gmsh::getSkin(const Partition &partition, const uint bucket,
+                      IndexMap &indices, std::vector<Vertex> &vertices) const {
+  return this->makeSkin(
+      partition.labels.at(bucket),
+      partition.elements.cbegin() + partition.offsets.at(bucket),
+      partition.elements.cbegin() + partition.offsets.at(bucket + 1), indices,
+      &vertices);
+}
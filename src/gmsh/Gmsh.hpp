@@ -1,12 +1,18 @@
 #ifndef _GMSH_
 #define _GMSH_
 
+#include <cstdint>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "../geometry/Tetrahedron.hpp"
 #include "../geometry/Triangle.hpp"
 #include "../geometry/Vertex.hpp"
+#include "../utils/IndexMap.hpp"
+#include "../utils/Scanner.hpp"
+#include "../utils/TagMap.hpp"
 
 using uint = unsigned int;
 
@@ -30,6 +36,15 @@ struct Volume {
   std::vector<Vertex> vertices;
 };
 
+struct Partition {
+  // Bucket labels
+  std::vector<uint> labels;
+  // CSR offsets, labels.size() + 1
+  std::vector<uint> offsets;
+  // Element ids, grouped by bucket
+  std::vector<uint> elements;
+};
+
 /**
  * Gmsh class
  */
@@ -45,6 +60,53 @@ private:
   std::vector<Tetrahedron> m_tetrahedra = std::vector<Tetrahedron>();
   // Tetrahedron labels
   std::vector<uint> m_tetrahedronLabels = std::vector<uint>();
+  // Selected physical groups, (dimension << 32) | tag, empty for all
+  std::unordered_set<uint64_t> m_groups = std::unordered_set<uint64_t>();
+
+  // Select physical groups
+  bool selectGroups(const char *, const char *,
+                    const std::vector<std::string> &);
+  // Remove unreferenced vertices
+  void removeUnreferencedVertices();
+
+  // Load MSH 2 ASCII
+  bool loadAscii2(Scanner &, const char *);
+  // Load MSH 2 binary
+  bool loadBinary2(Scanner &);
+  // Load MSH 4.1
+  bool loadMsh4(Scanner &, const char *, const bool);
+
+  // Read nodes
+  bool readNodes(const char *, const char *, const uint, TagMap &);
+  // Read elements
+  bool readElements(const char *, const char *, const uint, const TagMap &);
+
+  // Read binary nodes (MSH 2)
+  bool readBinaryNodes2(Scanner &, const uint, TagMap &);
+  // Read binary elements (MSH 2)
+  bool readBinaryElements2(Scanner &, const uint, const TagMap &);
+
+  // Read nodes (MSH 4.1)
+  bool readNodes4(Scanner &, const bool, TagMap &);
+  // Read elements (MSH 4.1)
+  bool readElements4(Scanner &, const bool, const TagMap &,
+                     const std::unordered_map<uint64_t, uint> &);
+
+  // Make surface
+  Surface makeSurface(const uint, const std::vector<Triangle> &,
+                      std::vector<uint>::const_iterator,
+                      std::vector<uint>::const_iterator, IndexMap &) const;
+  Surface makeSurface(const uint, const std::vector<Triangle> &,
+                      std::vector<uint>::const_iterator,
+                      std::vector<uint>::const_iterator, IndexMap &,
+                      std::vector<Vertex> &) const;
+  // Make volume
+  Volume makeVolume(const uint, std::vector<uint>::const_iterator,
+                    std::vector<uint>::const_iterator, IndexMap &) const;
+  // Make skin
+  Surface makeSkin(const uint, std::vector<uint>::const_iterator,
+                   std::vector<uint>::const_iterator, IndexMap &,
+                   std::vector<Vertex> *) const;
 
 public:
   // Constructor
@@ -52,12 +114,39 @@ public:
 
   // Loader
   bool load(const std::string &);
+  bool load(const std::string &, const std::vector<std::string> &);
 
   // Get surface labels
   std::vector<uint> getSurfaceLabels() const;
 
+  // Partition triangles by label
+  Partition partitionTriangles() const;
+
   // Get surface
   Surface getSurface(const uint) const;
+  Surface getSurface(const uint, IndexMap &) const;
+  Surface getSurface(const Partition &, const uint, IndexMap &) const;
+  Surface getSurface(const Partition &, const uint, IndexMap &,
+                     std::vector<Vertex> &) const;
+
+  // Get surfaces
+  std::vector<Surface> getSurfaces() const;
+
+  // Get volume labels
+  std::vector<uint> getVolumeLabels() const;
+
+  // Partition tetrahedra by label
+  Partition partitionTetrahedra() const;
+
+  // Get volume
+  Volume getVolume(const uint) const;
+  Volume getVolume(const Partition &, const uint, IndexMap &) const;
+
+  // Get skin (boundary surface of a volume)
+  Surface getSkin(const uint) const;
+  Surface getSkin(const Partition &, const uint, IndexMap &) const;
+  Surface getSkin(const Partition &, const uint, IndexMap &,
+                  std::vector<Vertex> &) const;
 };
 
 #endif //_GMSH_
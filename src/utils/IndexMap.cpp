@@ -0,0 +1,99 @@
+#include "IndexMap.hpp"
+
+#include <algorithm>
+
+/**
+ * Constructor
+ */
+IndexMap::IndexMap() = default;
+
+/**
+ * Constructor
+ * @param capacity Dense capacity
+ */
+IndexMap::IndexMap(const uint capacity) { this->reserve(capacity); }
+
+/**
+ * Reserve dense capacity
+ * @param capacity Dense capacity
+ */
+void IndexMap::reserve(const uint capacity) {
+  if (capacity <= this->m_stamps.size())
+    return;
+
+  this->m_stamps.resize(capacity, 0);
+  this->m_dense.resize(capacity, 0);
+
+  // Move sparse entries now covered by the dense table
+  for (auto entry = this->m_sparse.begin(); entry != this->m_sparse.end();) {
+    if (entry->first < capacity) {
+      this->m_stamps[entry->first] = this->m_generation;
+      this->m_dense[entry->first] = entry->second;
+      entry = this->m_sparse.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+}
+
+/**
+ * Clear
+ */
+void IndexMap::clear() {
+  this->m_generation++;
+  if (!this->m_generation) {
+    // Wrap around, stale stamps would match again
+    std::fill(this->m_stamps.begin(), this->m_stamps.end(), 0);
+    this->m_generation = 1;
+  }
+
+  this->m_sparse.clear();
+  this->m_size = 0;
+}
+
+/**
+ * Find
+ * @param index Original index
+ * @return New index, -1 if not found
+ */
+int IndexMap::find(const uint index) const {
+  if (index < this->m_stamps.size()) {
+    if (this->m_stamps[index] == this->m_generation)
+      return (int)this->m_dense[index];
+    return -1;
+  }
+
+  auto find = this->m_sparse.find(index);
+  if (find == this->m_sparse.end())
+    return -1;
+  return (int)find->second;
+}
+
+/**
+ * Insert
+ * @param index Original index
+ * @param inserted True if the index was not mapped yet
+ * @return New index
+ */
+uint IndexMap::insert(const uint index, bool &inserted) {
+  if (index < this->m_stamps.size()) {
+    inserted = this->m_stamps[index] != this->m_generation;
+    if (inserted) {
+      this->m_stamps[index] = this->m_generation;
+      this->m_dense[index] = this->m_size++;
+    }
+    return this->m_dense[index];
+  }
+
+  auto [entry, isNew] = this->m_sparse.try_emplace(index, this->m_size);
+  inserted = isNew;
+  if (inserted)
+    this->m_size++;
+  return entry->second;
+}
+
+/**
+ * Size
+ * @return Number of mapped indices
+ */
+uint IndexMap::size() const { return this->m_size; }
@@ -0,0 +1,51 @@
+#ifndef _INDEX_MAP_
+#define _INDEX_MAP_
+
+#include <unordered_map>
+#include <vector>
+
+using uint = unsigned int;
+
+/**
+ * IndexMap class
+ * Compacts original indices into 0..size-1, in insertion order.
+ * Indices below the dense capacity use a generation-stamped table, so clearing
+ * is O(1) and the map can be reused without reallocation. Other indices fall
+ * back to a hash map.
+ */
+class IndexMap {
+private:
+  // Generation
+  uint m_generation = 1;
+  // Dense stamps
+  std::vector<uint> m_stamps = std::vector<uint>();
+  // Dense new indices
+  std::vector<uint> m_dense = std::vector<uint>();
+  // Sparse new indices
+  std::unordered_map<uint, uint> m_sparse = std::unordered_map<uint, uint>();
+  // Size
+  uint m_size = 0;
+
+public:
+  // Constructor
+  IndexMap();
+  // Constructor
+  explicit IndexMap(const uint);
+
+  // Reserve dense capacity
+  void reserve(const uint);
+
+  // Clear
+  void clear();
+
+  // Find
+  int find(const uint) const;
+
+  // Insert
+  uint insert(const uint, bool &);
+
+  // Size
+  uint size() const;
+};
+
+#endif //_INDEX_MAP_
@@ -0,0 +1,78 @@
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Constructor
+ */
+MappedFile::MappedFile() = default;
+
+/**
+ * Destructor
+ */
+MappedFile::~MappedFile() { this->unmap(); }
+
+/**
+ * Unmap
+ */
+void MappedFile::unmap() {
+  if (this->m_data && this->m_size)
+    munmap((void *)this->m_data, this->m_size);
+
+  this->m_data = nullptr;
+  this->m_size = 0;
+}
+
+/**
+ * Open
+ * @param fileName File name
+ * @return Status
+ */
+bool MappedFile::open(const std::string &fileName) {
+  this->unmap();
+
+  const int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  struct stat status;
+  if (fstat(fd, &status) < 0 || !S_ISREG(status.st_mode)) {
+    close(fd);
+    return false;
+  }
+
+  // Empty file, nothing to map
+  if (!status.st_size) {
+    close(fd);
+    return true;
+  }
+
+  void *data =
+      mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+
+  // The file is read front to back
+  madvise(data, (size_t)status.st_size, MADV_SEQUENTIAL);
+
+  this->m_data = (const char *)data;
+  this->m_size = (size_t)status.st_size;
+
+  return true;
+}
+
+/**
+ * Data
+ * @return Data
+ */
+const char *MappedFile::data() const { return this->m_data; }
+
+/**
+ * Size
+ * @return Size
+ */
+size_t MappedFile::size() const { return this->m_size; }
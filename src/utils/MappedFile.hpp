@@ -0,0 +1,40 @@
+#ifndef _MAPPED_FILE_
+#define _MAPPED_FILE_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * MappedFile class
+ * Read-only memory mapping of a whole file
+ */
+class MappedFile {
+private:
+  // Data
+  const char *m_data = nullptr;
+  // Size
+  size_t m_size = 0;
+
+  // Unmap
+  void unmap();
+
+public:
+  // Constructor
+  MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // Destructor
+  ~MappedFile();
+
+  // Open
+  bool open(const std::string &);
+
+  // Data
+  const char *data() const;
+
+  // Size
+  size_t size() const;
+};
+
+#endif //_MAPPED_FILE_
@@ -0,0 +1,175 @@
+#include "Scanner.hpp"
+
+#include <charconv>
+#include <cstring>
+
+/**
+ * Is space
+ * @param c Character
+ * @return Status
+ */
+static inline bool isSpace(const char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+/**
+ * Constructor
+ */
+Scanner::Scanner() = default;
+
+/**
+ * Constructor
+ * @param begin Begin
+ * @param end End
+ */
+Scanner::Scanner(const char *begin, const char *end)
+    : m_current(begin), m_end(end) {}
+
+/**
+ * Skip whitespaces
+ */
+void Scanner::skipSpaces() {
+  while (this->m_current < this->m_end && isSpace(*this->m_current))
+    this->m_current++;
+}
+
+/**
+ * End of range
+ * @return Status
+ */
+bool Scanner::eof() {
+  this->skipSpaces();
+  return this->m_current >= this->m_end;
+}
+
+/**
+ * Current position
+ * @return Position
+ */
+const char *Scanner::position() const { return this->m_current; }
+
+/**
+ * Next token
+ * @return Token, empty at the end of range
+ */
+std::string_view Scanner::token() {
+  this->skipSpaces();
+
+  const char *begin = this->m_current;
+  while (this->m_current < this->m_end && !isSpace(*this->m_current))
+    this->m_current++;
+
+  return std::string_view(begin, this->m_current - begin);
+}
+
+/**
+ * Skip to token
+ * @param expected Expected token
+ * @return True if found, the scanner is then just after it
+ */
+bool Scanner::skipTo(const std::string_view &expected) {
+  while (!this->eof())
+    if (this->token() == expected)
+      return true;
+
+  return false;
+}
+
+/**
+ * Skip to next line
+ */
+void Scanner::skipLine() {
+  // Usually at the end of the line already
+  while (this->m_current < this->m_end &&
+         (*this->m_current == ' ' || *this->m_current == '\t' ||
+          *this->m_current == '\r'))
+    this->m_current++;
+  if (this->m_current < this->m_end && *this->m_current == '\n') {
+    this->m_current++;
+    return;
+  }
+
+  const auto *eol = (const char *)std::memchr(this->m_current, '\n',
+                                              this->m_end - this->m_current);
+  this->m_current = eol ? eol + 1 : this->m_end;
+}
+
+/**
+ * Read unsigned int
+ * @param value Value
+ * @return Status
+ */
+bool Scanner::read(uint &value) {
+  this->skipSpaces();
+
+  auto [end, error] = std::from_chars(this->m_current, this->m_end, value);
+  if (error != std::errc())
+    return false;
+
+  this->m_current = end;
+  return true;
+}
+
+/**
+ * Read int
+ * @param value Value
+ * @return Status
+ */
+bool Scanner::read(int &value) {
+  this->skipSpaces();
+
+  auto [end, error] = std::from_chars(this->m_current, this->m_end, value);
+  if (error != std::errc())
+    return false;
+
+  this->m_current = end;
+  return true;
+}
+
+/**
+ * Read double
+ * @param value Value
+ * @return Status
+ */
+bool Scanner::read(double &value) {
+  this->skipSpaces();
+
+  // from_chars does not accept a leading +
+  if (this->m_current < this->m_end && *this->m_current == '+')
+    this->m_current++;
+
+  auto [end, error] = std::from_chars(this->m_current, this->m_end, value);
+  if (error != std::errc())
+    return false;
+
+  this->m_current = end;
+  return true;
+}
+
+/**
+ * Read raw bytes
+ * @param data Destination
+ * @param size Number of bytes
+ * @return Status
+ */
+bool Scanner::readBytes(void *data, const size_t size) {
+  if ((size_t)(this->m_end - this->m_current) < size)
+    return false;
+
+  std::memcpy(data, this->m_current, size);
+  this->m_current += size;
+  return true;
+}
+
+/**
+ * Skip raw bytes
+ * @param size Number of bytes
+ * @return Status
+ */
+bool Scanner::skipBytes(const size_t size) {
+  if ((size_t)(this->m_end - this->m_current) < size)
+    return false;
+
+  this->m_current += size;
+  return true;
+}
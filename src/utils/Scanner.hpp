@@ -0,0 +1,55 @@
+#ifndef _SCANNER_
+#define _SCANNER_
+
+#include <cstddef>
+#include <string_view>
+
+using uint = unsigned int;
+
+/**
+ * Scanner class
+ * Whitespace separated tokens over a raw character range, without allocation
+ */
+class Scanner {
+private:
+  // Current position
+  const char *m_current = nullptr;
+  // End
+  const char *m_end = nullptr;
+
+  // Skip whitespaces
+  void skipSpaces();
+
+public:
+  // Constructor
+  Scanner();
+  // Constructor
+  Scanner(const char *, const char *);
+
+  // End of range
+  bool eof();
+
+  // Current position
+  const char *position() const;
+
+  // Next token
+  std::string_view token();
+
+  // Skip to token
+  bool skipTo(const std::string_view &);
+
+  // Skip to next line
+  void skipLine();
+
+  // Read
+  bool read(uint &);
+  bool read(int &);
+  bool read(double &);
+
+  // Read raw bytes
+  bool readBytes(void *, const size_t);
+  // Skip raw bytes
+  bool skipBytes(const size_t);
+};
+
+#endif //_SCANNER_
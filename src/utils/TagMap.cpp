@@ -0,0 +1,92 @@
+#include "TagMap.hpp"
+
+/**
+ * Constructor
+ */
+TagMap::TagMap() = default;
+
+/**
+ * Slot
+ * @param tag Tag
+ * @return First slot to probe
+ */
+size_t TagMap::slot(const size_t tag) const {
+  // Fibonacci hashing, spreads consecutive tags
+  return (size_t)((tag * 0x9E3779B97F4A7C15ull) >> 32) & this->m_mask;
+}
+
+/**
+ * Build
+ * @param tags Tags, tags[i] is mapped to i
+ * @return False on a null or duplicated tag
+ */
+bool TagMap::build(const std::vector<size_t> &tags) {
+  this->m_size = (uint)tags.size();
+  this->m_offset = tags.empty() ? 0 : tags.front();
+  this->m_keys.clear();
+  this->m_values.clear();
+  this->m_mask = 0;
+
+  // Contiguous
+  this->m_dense = true;
+  for (size_t i = 0; i < tags.size() && this->m_dense; ++i)
+    this->m_dense = tags[i] == this->m_offset + i;
+  if (this->m_dense)
+    return !this->m_size || this->m_offset;
+
+  // Open addressing, load factor <= 0.5
+  size_t capacity = 2;
+  while (capacity < 2 * tags.size())
+    capacity *= 2;
+  this->m_mask = capacity - 1;
+  this->m_keys.assign(capacity, 0);
+  this->m_values.resize(capacity);
+
+  for (size_t i = 0; i < tags.size(); ++i) {
+    const size_t tag = tags[i];
+    if (!tag)
+      return false;
+
+    size_t position = this->slot(tag);
+    while (this->m_keys[position]) {
+      if (this->m_keys[position] == tag)
+        return false;
+      position = (position + 1) & this->m_mask;
+    }
+    this->m_keys[position] = tag;
+    this->m_values[position] = (uint)i;
+  }
+
+  return true;
+}
+
+/**
+ * Dense
+ * @return True if tags are contiguous
+ */
+bool TagMap::dense() const { return this->m_dense; }
+
+/**
+ * Find in table
+ * @param tag Tag
+ * @return Position, -1 if not found
+ */
+int TagMap::findSparse(const size_t tag) const {
+  if (!tag)
+    return -1;
+
+  size_t position = this->slot(tag);
+  while (this->m_keys[position]) {
+    if (this->m_keys[position] == tag)
+      return (int)this->m_values[position];
+    position = (position + 1) & this->m_mask;
+  }
+
+  return -1;
+}
+
+/**
+ * Size
+ * @return Size
+ */
+uint TagMap::size() const { return this->m_size; }
@@ -0,0 +1,68 @@
+#ifndef _TAG_MAP_
+#define _TAG_MAP_
+
+#include <cstddef>
+#include <vector>
+
+using uint = unsigned int;
+
+/**
+ * TagMap class
+ * Maps node tags to their position. Contiguous tags (first, first + 1, ...)
+ * are resolved with an offset. Other tags go through a compact open
+ * addressing table.
+ */
+class TagMap {
+private:
+  // Dense, tags are contiguous
+  bool m_dense = true;
+  // First tag, when dense
+  size_t m_offset = 0;
+  // Size
+  uint m_size = 0;
+  // Table mask, capacity - 1
+  size_t m_mask = 0;
+  // Table keys, 0 is empty
+  std::vector<size_t> m_keys = std::vector<size_t>();
+  // Table values
+  std::vector<uint> m_values = std::vector<uint>();
+
+  // Slot
+  size_t slot(const size_t) const;
+
+  // Find in table
+  int findSparse(const size_t) const;
+
+public:
+  // Constructor
+  TagMap();
+
+  // Build
+  bool build(const std::vector<size_t> &);
+
+  // Dense
+  bool dense() const;
+
+  // Find
+  int find(const size_t) const;
+
+  // Size
+  uint size() const;
+};
+
+/**
+ * Find
+ * Inline, called for every element node
+ * @param tag Tag
+ * @return Position, -1 if not found
+ */
+inline int TagMap::find(const size_t tag) const {
+  if (this->m_dense) {
+    const size_t index = tag - this->m_offset;
+    return tag >= this->m_offset && index < this->m_size ? (int)index : -1;
+  }
+
+  return this->findSparse(tag);
+}
+
+#endif //_TAG_MAP_
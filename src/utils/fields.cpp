@@ -0,0 +1,237 @@
+#include "fields.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace Fields {
+
+// Independent min / max lanes
+static const size_t lanes = 8;
+
+/**
+ * Lanes min / max
+ */
+template <typename T> struct Lanes {
+  T min[lanes];
+  T max[lanes];
+
+  /**
+   * Constructor
+   * @param value First value
+   */
+  explicit Lanes(const T value) {
+    std::fill(this->min, this->min + lanes, value);
+    std::fill(this->max, this->max + lanes, value);
+  }
+
+  /**
+   * Update
+   * @param lane Lane
+   * @param value Value
+   */
+  inline void update(const size_t lane, const T value) {
+    this->min[lane] = value < this->min[lane] ? value : this->min[lane];
+    this->max[lane] = value > this->max[lane] ? value : this->max[lane];
+  }
+
+  /**
+   * Reduce
+   * @return { min, max }
+   */
+  std::vector<double> reduce() const {
+    return {(double)*std::min_element(this->min, this->min + lanes),
+            (double)*std::max_element(this->max, this->max + lanes)};
+  }
+};
+
+/**
+ * Range
+ * @param values Values
+ * @param count Number of values
+ * @return { min, max }, { 0, 0 } if empty
+ */
+template <typename T>
+std::vector<double> range(const T *values, const size_t count) {
+  if (!count)
+    return {0, 0};
+
+  Lanes<T> result(values[0]);
+  size_t i = 0;
+  for (; i + lanes <= count; i += lanes)
+    for (size_t lane = 0; lane < lanes; ++lane)
+      result.update(lane, values[i + lane]);
+  for (; i < count; ++i)
+    result.update(0, values[i]);
+
+  return result.reduce();
+}
+
+/**
+ * Range (one component)
+ * @param values Values, size components per tuple
+ * @param count Number of tuples
+ * @param size Number of components
+ * @param index Component index
+ * @return { min, max }, { 0, 0 } if empty
+ */
+template <typename T>
+std::vector<double> range(const T *values, const size_t count, const int size,
+                          const int index) {
+  if (!count)
+    return {0, 0};
+
+  Lanes<T> result(values[index]);
+  size_t i = 0;
+  for (; i + lanes <= count; i += lanes)
+    for (size_t lane = 0; lane < lanes; ++lane)
+      result.update(lane, values[(i + lane) * size + index]);
+  for (; i < count; ++i)
+    result.update(0, values[i * size + index]);
+
+  return result.reduce();
+}
+
+/**
+ * Magnitude
+ * Computed in double, stored as float
+ * @param values Values, 3 components per tuple
+ * @param count Number of tuples
+ * @param magnitudes Magnitudes
+ * @return { min, max } of the magnitudes
+ */
+template <typename T>
+std::vector<double> magnitude(const T *values, const size_t count,
+                              std::vector<float> &magnitudes) {
+  magnitudes.resize(count);
+  if (!count)
+    return {0, 0};
+
+  float *output = magnitudes.data();
+  const auto norm = [values](const size_t i) {
+    const double x = values[3 * i + 0];
+    const double y = values[3 * i + 1];
+    const double z = values[3 * i + 2];
+    return (float)std::sqrt(x * x + y * y + z * z);
+  };
+
+  Lanes<float> result(norm(0));
+  size_t i = 0;
+  for (; i + lanes <= count; i += lanes)
+    for (size_t lane = 0; lane < lanes; ++lane) {
+      const float value = norm(i + lane);
+      output[i + lane] = value;
+      result.update(lane, value);
+    }
+  for (; i < count; ++i) {
+    const float value = norm(i);
+    output[i] = value;
+    result.update(0, value);
+  }
+
+  return result.reduce();
+}
+
+/**
+ * Component
+ * @param values Values, size components per tuple
+ * @param count Number of tuples
+ * @param size Number of components
+ * @param index Component index
+ * @param components Components
+ * @return { min, max } of the components
+ */
+template <typename T>
+std::vector<double> component(const T *values, const size_t count,
+                              const int size, const int index,
+                              std::vector<float> &components) {
+  components.resize(count);
+  if (!count)
+    return {0, 0};
+
+  float *output = components.data();
+  Lanes<float> result((float)values[index]);
+  size_t i = 0;
+  for (; i + lanes <= count; i += lanes)
+    for (size_t lane = 0; lane < lanes; ++lane) {
+      const auto value = (float)values[(i + lane) * size + index];
+      output[i + lane] = value;
+      result.update(lane, value);
+    }
+  for (; i < count; ++i) {
+    const auto value = (float)values[i * size + index];
+    output[i] = value;
+    result.update(0, value);
+  }
+
+  return result.reduce();
+}
+
+/**
+ * Quantize
+ * Out of range values are clamped, NaN are mapped to 0. A constant component
+ * is mapped to 0
+ * @param values Values, size components per tuple
+ * @param count Number of tuples
+ * @param size Number of components
+ * @param minValues Min values, per component
+ * @param maxValues Max values, per component
+ * @param buffer Buffer, appended
+ * @return Byte stride
+ */
+template <typename T>
+size_t quantize(const T *values, const size_t count, const int size,
+                const std::vector<double> &minValues,
+                const std::vector<double> &maxValues,
+                std::vector<unsigned char> &buffer) {
+  const size_t stride = (size * sizeof(uint16_t) + 3) / 4 * 4;
+
+  std::vector<double> scales(size, 0);
+  for (int k = 0; k < size; ++k) {
+    const double extent = maxValues.at(k) - minValues.at(k);
+    scales[k] = extent > 0 ? 65535. / extent : 0;
+  }
+
+  const size_t offset = buffer.size();
+  buffer.resize(offset + count * stride, 0x00);
+  unsigned char *output = buffer.data() + offset;
+  for (size_t i = 0; i < count; ++i)
+    for (int k = 0; k < size; ++k) {
+      const double value = (values[i * size + k] - minValues[k]) * scales[k];
+      const auto quantized =
+          (uint16_t)(value > 0 ? (value < 65535. ? value + .5 : 65535.) : 0.);
+      std::memcpy(output + i * stride + k * sizeof(uint16_t), &quantized,
+                  sizeof(uint16_t));
+    }
+
+  return stride;
+}
+
+// float & double instances
+template std::vector<double> range(const float *, const size_t);
+template std::vector<double> range(const double *, const size_t);
+template std::vector<double> range(const float *, const size_t, const int,
+                                   const int);
+template std::vector<double> range(const double *, const size_t, const int,
+                                   const int);
+template std::vector<double> magnitude(const float *, const size_t,
+                                       std::vector<float> &);
+template std::vector<double> magnitude(const double *, const size_t,
+                                       std::vector<float> &);
+template std::vector<double> component(const float *, const size_t,
+                                       const int, const int,
+                                       std::vector<float> &);
+template std::vector<double> component(const double *, const size_t,
+                                       const int, const int,
+                                       std::vector<float> &);
+template size_t quantize(const float *, const size_t, const int,
+                         const std::vector<double> &,
+                         const std::vector<double> &,
+                         std::vector<unsigned char> &);
+template size_t quantize(const double *, const size_t, const int,
+                         const std::vector<double> &,
+                         const std::vector<double> &,
+                         std::vector<unsigned char> &);
+
+} // namespace Fields
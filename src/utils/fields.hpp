@@ -0,0 +1,76 @@
+#ifndef _FIELDS_
+#define _FIELDS_
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Derived fields
+ * Fused single pass kernels over contiguous float or double values. The
+ * min / max are kept in independent lanes so the loops vectorize.
+ */
+namespace Fields {
+
+/**
+ * Range
+ * @param values Values
+ * @param count Number of values
+ * @return { min, max }, { 0, 0 } if empty
+ */
+template <typename T>
+std::vector<double> range(const T *, const size_t);
+
+/**
+ * Range (one component)
+ * @param values Values, size components per tuple
+ * @param count Number of tuples
+ * @param size Number of components
+ * @param index Component index
+ * @return { min, max }, { 0, 0 } if empty
+ */
+template <typename T>
+std::vector<double> range(const T *, const size_t, const int, const int);
+
+/**
+ * Magnitude
+ * @param values Values, 3 components per tuple
+ * @param count Number of tuples
+ * @param magnitudes Magnitudes
+ * @return { min, max } of the magnitudes
+ */
+template <typename T>
+std::vector<double> magnitude(const T *, const size_t, std::vector<float> &);
+
+/**
+ * Component
+ * @param values Values, size components per tuple
+ * @param count Number of tuples
+ * @param size Number of components
+ * @param index Component index
+ * @param components Components
+ * @return { min, max } of the components
+ */
+template <typename T>
+std::vector<double> component(const T *, const size_t, const int, const int,
+                              std::vector<float> &);
+
+/**
+ * Quantize
+ * Normalized unsigned short tuples, each component mapped from [min, max] to
+ * [0, 65535]. Tuples are padded to 4 bytes, the glTF vertex attributes
+ * alignment
+ * @param values Values, size components per tuple
+ * @param count Number of tuples
+ * @param size Number of components
+ * @param minValues Min values, per component
+ * @param maxValues Max values, per component
+ * @param buffer Buffer, appended
+ * @return Byte stride
+ */
+template <typename T>
+size_t quantize(const T *, const size_t, const int, const std::vector<double> &,
+                const std::vector<double> &, std::vector<unsigned char> &);
+
+} // namespace Fields
+
+#endif //_FIELDS_
@@ -1,9 +1,15 @@
 #include "utils.hpp"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
+#include <mutex>
 #include <random>
 #include <string>
+#include <thread>
+#include <tuple>
 #include <uuid/uuid.h>
 
 namespace Utils {
@@ -47,35 +53,30 @@ void uintToBuffer(uint value, std::vector<unsigned char> &buffer) {
 }
 
 /**
- * Float to buffer
+ * Unsigned short to buffer
  * @param value Value
  * @param buffer Buffer
  */
-void floatToBuffer(float value, std::vector<unsigned char> &buffer) {
-  unsigned char buf[__SIZEOF_FLOAT__];
-  std::memcpy(buf, &value, __SIZEOF_FLOAT__);
+void ushortToBuffer(unsigned short value, std::vector<unsigned char> &buffer) {
+  unsigned char buf[__SIZEOF_SHORT__];
+  std::memcpy(buf, &value, __SIZEOF_SHORT__);
 
-  for (size_t i = 0; i < __SIZEOF_FLOAT__; ++i) {
+  for (size_t i = 0; i < __SIZEOF_SHORT__; ++i) {
     buffer.push_back(buf[i]);
   }
 }
 
 /**
- * Find index
- * @param index Index
- * @param indices Indices
- * @return Find
+ * Float to buffer
+ * @param value Value
+ * @param buffer Buffer
  */
-int findIndex(uint index, const std::vector<std::pair<uint, uint>> &indices) {
-  auto find = std::find_if(indices.begin(), indices.end(),
-                           [index](const std::pair<uint, uint> indexPair) {
-                             return indexPair.first == index;
-                           });
+void floatToBuffer(float value, std::vector<unsigned char> &buffer) {
+  unsigned char buf[__SIZEOF_FLOAT__];
+  std::memcpy(buf, &value, __SIZEOF_FLOAT__);
 
-  if (find == indices.end()) {
-    return -1;
-  } else {
-    return (*find).second;
+  for (size_t i = 0; i < __SIZEOF_FLOAT__; ++i) {
+    buffer.push_back(buf[i]);
   }
 }
 
@@ -126,19 +127,16 @@ std::vector<uint> minMax(const std::vector<Triangle> &triangles) {
 
 /**
  * Min / Max (indices)
- * @param polygons Polygons
+ * @param polylines Polylines
  * @return { min, max }
  */
-std::vector<uint> minMax(const std::vector<Polygon> &polygons) {
+std::vector<uint> minMax(const Polylines &polylines) {
   uint min = 0; // Min is always 0
   uint max = 0;
 
-  // Polygons
-  std::for_each(
-      polygons.begin(), polygons.end(), [&max](const Polygon &polygon) {
-        const std::vector<uint> indices = polygon.getIndices();
-        max = std::max(max, *std::max_element(indices.begin(), indices.end()));
-      });
+  const std::vector<uint> &indices = polylines.getIndices();
+  if (indices.size())
+    max = *std::max_element(indices.begin(), indices.end());
 
   return {min, max};
 }
@@ -187,6 +185,364 @@ std::vector<double> minMax(const std::vector<double> &values) {
   return {min, max};
 }
 
+/**
+ * Min / Max (float values)
+ * @param values Values
+ * @return { min, max }
+ */
+std::vector<double> minMax(const std::vector<float> &values) {
+  float min = values.size() ? values.at(0) : 0;
+  float max = values.size() ? values.at(0) : 0;
+
+  std::for_each(values.begin(), values.end(), [&min, &max](const float value) {
+    min = std::min(min, value);
+    max = std::max(max, value);
+  });
+
+  return {min, max};
+}
+
+/**
+ * Number of threads
+ * @return Hardware concurrency, at least 1
+ */
+uint numberOfThreads() {
+  const uint numberOfThreads = std::thread::hardware_concurrency();
+  return numberOfThreads ? numberOfThreads : 1;
+}
+
+/**
+ * Parallel for
+ * @param count Count
+ * @param job Job
+ */
+void parallelFor(const size_t count,
+                 const std::function<void(const size_t)> &job) {
+  const size_t numberOfWorkers =
+      std::min(count, (size_t)Utils::numberOfThreads());
+  if (numberOfWorkers <= 1) {
+    for (size_t i = 0; i < count; ++i)
+      job(i);
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  std::exception_ptr exception;
+  std::mutex exceptionMutex;
+
+  std::vector<std::thread> workers;
+  workers.reserve(numberOfWorkers);
+  for (size_t worker = 0; worker < numberOfWorkers; ++worker)
+    workers.emplace_back([count, &job, &next, &exception, &exceptionMutex]() {
+      for (size_t i = next++; i < count; i = next++) {
+        try {
+          job(i);
+        } catch (...) {
+          std::lock_guard<std::mutex> lock(exceptionMutex);
+          if (!exception)
+            exception = std::current_exception();
+        }
+      }
+    });
+
+  std::for_each(workers.begin(), workers.end(),
+                [](std::thread &worker) { worker.join(); });
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+/**
+ * Parallel for, memory bounded
+ * @param count Count
+ * @param numberOfWorkers Number of workers
+ * @param budget Budget
+ * @param cost Cost of each job
+ * @param job Job
+ */
+void parallelFor(const size_t count, const size_t numberOfWorkers,
+                 const size_t budget,
+                 const std::function<size_t(const size_t)> &cost,
+                 const std::function<void(const size_t)> &job) {
+  const size_t workersCount = std::min(count, numberOfWorkers);
+  if (workersCount <= 1) {
+    for (size_t i = 0; i < count; ++i)
+      job(i);
+    return;
+  }
+
+  std::vector<size_t> costs(count);
+  for (size_t i = 0; i < count; ++i)
+    costs[i] = cost(i);
+
+  size_t next = 0;
+  size_t used = 0;
+  size_t running = 0;
+  std::mutex mutex;
+  std::condition_variable released;
+  std::exception_ptr exception;
+
+  const auto work = [count, &job, &costs, budget, &next, &used, &running,
+                     &mutex, &released, &exception]() {
+    while (true) {
+      size_t i;
+      {
+        // The next job only, so that jobs start in order
+        std::unique_lock<std::mutex> lock(mutex);
+        released.wait(lock, [count, &costs, budget, &next, &used, &running]() {
+          return next >= count || !running || used + costs[next] <= budget;
+        });
+        if (next >= count)
+          return;
+
+        i = next++;
+        used += costs[i];
+        running++;
+      }
+      released.notify_all();
+
+      try {
+        job(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!exception)
+          exception = std::current_exception();
+      }
+
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        used -= costs[i];
+        running--;
+      }
+      released.notify_all();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(workersCount);
+  for (size_t worker = 0; worker < workersCount; ++worker)
+    workers.emplace_back(work);
+
+  std::for_each(workers.begin(), workers.end(),
+                [](std::thread &worker) { worker.join(); });
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+/**
+ * Tetrahedron faces, outward for a positive tetrahedron
+ */
+static const uint tetrahedronFaces[4][3] = {
+    {0, 2, 1}, {0, 1, 3}, {0, 3, 2}, {1, 2, 3}};
+
+/**
+ * Skin face
+ * Sorted vertex indices, and 4 * element position + local face
+ */
+struct SkinFace {
+  uint key[3];
+  uint id;
+
+  bool operator<(const SkinFace &other) const {
+    return std::tie(key[0], key[1], key[2]) <
+           std::tie(other.key[0], other.key[1], other.key[2]);
+  }
+
+  bool operator==(const SkinFace &other) const {
+    return key[0] == other.key[0] && key[1] == other.key[1] &&
+           key[2] == other.key[2];
+  }
+};
+
+/**
+ * Make skin face
+ * @param indices Tetrahedron indices
+ * @param id Face id
+ * @return Face
+ */
+static inline SkinFace makeSkinFace(const uint indices[4], const uint id) {
+  const uint *local = tetrahedronFaces[id % 4];
+  SkinFace face = {{indices[local[0]], indices[local[1]], indices[local[2]]},
+                   id};
+  if (face.key[0] > face.key[1])
+    std::swap(face.key[0], face.key[1]);
+  if (face.key[1] > face.key[2])
+    std::swap(face.key[1], face.key[2]);
+  if (face.key[0] > face.key[1])
+    std::swap(face.key[0], face.key[1]);
+  return face;
+}
+
+/**
+ * Skin face bucket
+ * @param face Face
+ * @param numberOfBuckets Number of buckets
+ * @return Bucket
+ */
+static inline size_t skinBucket(const SkinFace &face,
+                                const size_t numberOfBuckets) {
+  const size_t hash = (size_t)face.key[0] * 73856093u ^
+                      (size_t)face.key[1] * 19349663u ^
+                      (size_t)face.key[2] * 83492791u;
+  return hash % numberOfBuckets;
+}
+
+/**
+ * Skin
+ * Faces are hashed into buckets, each bucket is sorted, and faces found once
+ * are on the boundary
+ * @param count Number of tetrahedra
+ * @param tetrahedronAt Tetrahedron at position
+ * @param vertices Vertices
+ * @return Boundary triangles
+ */
+template <typename FuncT>
+static std::vector<Triangle> skinOf(const size_t count, FuncT tetrahedronAt,
+                                    const std::vector<Vertex> &vertices) {
+  const size_t numberOfChunks =
+      std::max((size_t)1, std::min((size_t)numberOfThreads(), count / 4096));
+  const size_t numberOfBuckets = numberOfChunks;
+  const auto chunkBegin = [count, numberOfChunks](const size_t chunk) {
+    return count * chunk / numberOfChunks;
+  };
+  const auto forEachFace = [&tetrahedronAt](const size_t begin,
+                                            const size_t end, auto job) {
+    for (size_t i = begin; i < end; ++i) {
+      const Tetrahedron &tetrahedron = tetrahedronAt(i);
+      const uint indices[4] = {tetrahedron.I1(), tetrahedron.I2(),
+                               tetrahedron.I3(), tetrahedron.I4()};
+      for (uint local = 0; local < 4; ++local)
+        job(makeSkinFace(indices, (uint)(4 * i + local)));
+    }
+  };
+
+  // Count faces, per chunk and bucket
+  std::vector<size_t> counts(numberOfChunks * numberOfBuckets, 0);
+  parallelFor(numberOfChunks, [&](const size_t chunk) {
+    size_t *chunkCounts = counts.data() + chunk * numberOfBuckets;
+    forEachFace(chunkBegin(chunk), chunkBegin(chunk + 1),
+                [chunkCounts, numberOfBuckets](const SkinFace &face) {
+                  chunkCounts[skinBucket(face, numberOfBuckets)]++;
+                });
+  });
+
+  // Cursors, bucket major
+  std::vector<size_t> offsets(numberOfBuckets + 1, 0);
+  std::vector<size_t> cursors(numberOfChunks * numberOfBuckets);
+  size_t offset = 0;
+  for (size_t bucket = 0; bucket < numberOfBuckets; ++bucket) {
+    offsets[bucket] = offset;
+    for (size_t chunk = 0; chunk < numberOfChunks; ++chunk) {
+      cursors[chunk * numberOfBuckets + bucket] = offset;
+      offset += counts[chunk * numberOfBuckets + bucket];
+    }
+  }
+  offsets[numberOfBuckets] = offset;
+
+  // Scatter
+  std::vector<SkinFace> faces(offset);
+  parallelFor(numberOfChunks, [&](const size_t chunk) {
+    size_t *chunkCursors = cursors.data() + chunk * numberOfBuckets;
+    forEachFace(chunkBegin(chunk), chunkBegin(chunk + 1),
+                [chunkCursors, numberOfBuckets, &faces](const SkinFace &face) {
+                  faces[chunkCursors[skinBucket(face, numberOfBuckets)]++] =
+                      face;
+                });
+  });
+
+  // Sort buckets, keep faces found once
+  std::vector<std::vector<uint>> boundaries(numberOfBuckets);
+  parallelFor(numberOfBuckets, [&](const size_t bucket) {
+    const auto begin = faces.begin() + offsets[bucket];
+    const auto end = faces.begin() + offsets[bucket + 1];
+    std::sort(begin, end);
+
+    for (auto face = begin; face != end;) {
+      auto next = face + 1;
+      while (next != end && *next == *face)
+        ++next;
+      if (next - face == 1)
+        boundaries[bucket].push_back(face->id);
+      face = next;
+    }
+  });
+
+  // Boundary faces, in element order
+  std::vector<uint> ids;
+  for (const std::vector<uint> &boundary : boundaries)
+    ids.insert(ids.end(), boundary.begin(), boundary.end());
+  std::sort(ids.begin(), ids.end());
+
+  std::vector<Triangle> triangles;
+  triangles.reserve(ids.size());
+  std::for_each(
+      ids.begin(), ids.end(),
+      [&tetrahedronAt, &vertices, &triangles](const uint id) {
+        const Tetrahedron &tetrahedron = tetrahedronAt(id / 4);
+        const uint indices[4] = {tetrahedron.I1(), tetrahedron.I2(),
+                                 tetrahedron.I3(), tetrahedron.I4()};
+        const uint *local = tetrahedronFaces[id % 4];
+
+        // Orientation
+        const Vertex &a = vertices.at(indices[0]);
+        const Vertex &b = vertices.at(indices[1]);
+        const Vertex &c = vertices.at(indices[2]);
+        const Vertex &d = vertices.at(indices[3]);
+        const double ab[3] = {b.X() - a.X(), b.Y() - a.Y(), b.Z() - a.Z()};
+        const double ac[3] = {c.X() - a.X(), c.Y() - a.Y(), c.Z() - a.Z()};
+        const double ad[3] = {d.X() - a.X(), d.Y() - a.Y(), d.Z() - a.Z()};
+        const double volume = ab[0] * (ac[1] * ad[2] - ac[2] * ad[1]) -
+                              ab[1] * (ac[0] * ad[2] - ac[2] * ad[0]) +
+                              ab[2] * (ac[0] * ad[1] - ac[1] * ad[0]);
+
+        if (volume < 0)
+          triangles.emplace_back(indices[local[0]], indices[local[2]],
+                                 indices[local[1]], tetrahedron.Label());
+        else
+          triangles.emplace_back(indices[local[0]], indices[local[1]],
+                                 indices[local[2]], tetrahedron.Label());
+      });
+
+  return triangles;
+}
+
+/**
+ * Skin
+ * @param tetrahedra Tetrahedra
+ * @param vertices Vertices
+ * @return Boundary triangles, oriented outward
+ */
+std::vector<Triangle> skin(const std::vector<Tetrahedron> &tetrahedra,
+                           const std::vector<Vertex> &vertices) {
+  return skinOf(
+      tetrahedra.size(),
+      [&tetrahedra](const size_t i) -> const Tetrahedron & {
+        return tetrahedra[i];
+      },
+      vertices);
+}
+
+/**
+ * Skin
+ * @param tetrahedra Tetrahedra
+ * @param vertices Vertices
+ * @param begin First tetrahedron id
+ * @param end Past the end tetrahedron id
+ * @return Boundary triangles, oriented outward
+ */
+std::vector<Triangle> skin(const std::vector<Tetrahedron> &tetrahedra,
+                           const std::vector<Vertex> &vertices,
+                           std::vector<uint>::const_iterator begin,
+                           std::vector<uint>::const_iterator end) {
+  return skinOf(
+      end - begin,
+      [&tetrahedra, begin](const size_t i) -> const Tetrahedron & {
+        return tetrahedra[begin[i]];
+      },
+      vertices);
+}
+
 /**
  * Remove file extension
  * @param str String
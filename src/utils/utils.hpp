@@ -1,9 +1,10 @@
 #ifndef _UTILS_
 #define _UTILS_
 
+#include <functional>
 #include <string>
 
-#include "../geometry/Polygon.hpp"
+#include "../geometry/Polylines.hpp"
 #include "../geometry/Tetrahedron.hpp"
 #include "../geometry/Triangle.hpp"
 #include "../geometry/Vertex.hpp"
@@ -30,19 +31,18 @@ double generateRandom();
 void uintToBuffer(uint, std::vector<unsigned char> &);
 
 /**
- * Float to buffer
+ * Unsigned short to buffer
  * @param value Value
  * @param buffer Buffer
  */
-void floatToBuffer(float, std::vector<unsigned char> &);
+void ushortToBuffer(unsigned short, std::vector<unsigned char> &);
 
 /**
- * Find index
- * @param index Index
- * @param indices Indices
- * @return Find
+ * Float to buffer
+ * @param value Value
+ * @param buffer Buffer
  */
-int findIndex(uint, const std::vector<std::pair<uint, uint>> &);
+void floatToBuffer(float, std::vector<unsigned char> &);
 
 /**
  * Min / Max (indices)
@@ -60,10 +60,10 @@ std::vector<uint> minMax(const std::vector<Triangle> &);
 
 /**
  * Min / Max (indices)
- * @param polygons Polygons
+ * @param polylines Polylines
  * @return { min, max }
  */
-std::vector<uint> minMax(const std::vector<Polygon> &);
+std::vector<uint> minMax(const Polylines &);
 
 /**
  * Min / Max (vertices)
@@ -79,6 +79,67 @@ std::vector<Vertex> minMax(const std::vector<Vertex> &);
  */
 std::vector<double> minMax(const std::vector<double> &);
 
+/**
+ * Min / Max (float values)
+ * @param values Values
+ * @return { min, max }
+ */
+std::vector<double> minMax(const std::vector<float> &);
+
+/**
+ * Number of threads
+ * @return Hardware concurrency, at least 1
+ */
+uint numberOfThreads();
+
+/**
+ * Parallel for
+ * Runs job(0) ... job(count - 1) on up to numberOfThreads() threads. The first
+ * exception thrown by a job is rethrown once every thread has joined.
+ * @param count Count
+ * @param job Job
+ */
+void parallelFor(const size_t, const std::function<void(const size_t)> &);
+
+/**
+ * Parallel for, memory bounded
+ * Jobs start in index order on up to numberOfWorkers threads. A job starts
+ * once its cost fits in the budget next to the running jobs, or alone. The
+ * first exception thrown by a job is rethrown once every thread has joined.
+ * @param count Count
+ * @param numberOfWorkers Number of workers
+ * @param budget Budget
+ * @param cost Cost of each job
+ * @param job Job
+ */
+void parallelFor(const size_t, const size_t, const size_t,
+                 const std::function<size_t(const size_t)> &,
+                 const std::function<void(const size_t)> &);
+
+/**
+ * Skin
+ * Boundary faces of tetrahedra, found once. Faces are hashed and sorted in
+ * parallel, and returned in element order.
+ * @param tetrahedra Tetrahedra
+ * @param vertices Vertices
+ * @return Boundary triangles, oriented outward
+ */
+std::vector<Triangle> skin(const std::vector<Tetrahedron> &,
+                           const std::vector<Vertex> &);
+
+/**
+ * Skin
+ * @param tetrahedra Tetrahedra
+ * @param vertices Vertices
+ * @param begin First tetrahedron id
+ * @param end Past the end tetrahedron id
+ * @return Boundary triangles, oriented outward
+ */
+std::vector<Triangle> skin(const std::vector<Tetrahedron> &,
+                           const std::vector<Vertex> &,
+                           std::vector<uint>::const_iterator,
+                           std::vector<uint>::const_iterator);
+
 /**
  * Remove extensions
  * @param str String
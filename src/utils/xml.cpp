@@ -0,0 +1,90 @@
+#include "xml.hpp"
+
+#include <cctype>
+
+namespace XML {
+
+/**
+ * Is space
+ * @param c Character
+ * @return Status
+ */
+static inline bool isSpace(const char c) {
+  return std::isspace((unsigned char)c) != 0;
+}
+
+/**
+ * Next tag
+ * @param content Content
+ * @param position Position
+ * @param tag Tag
+ * @return Status
+ */
+bool nextTag(const std::string_view &content, size_t &position, Tag &tag) {
+  while ((position = content.find('<', position)) != std::string_view::npos) {
+    // Comment
+    if (content.compare(position, 4, "<!--") == 0) {
+      position = content.find("-->", position);
+      if (position == std::string_view::npos)
+        return false;
+      position += 3;
+      continue;
+    }
+
+    const size_t end = content.find('>', position);
+    if (end == std::string_view::npos)
+      return false;
+
+    // Declaration & processing instruction
+    if (content.at(position + 1) == '?' || content.at(position + 1) == '!') {
+      position = end + 1;
+      continue;
+    }
+
+    tag.text = content.substr(position, end + 1 - position);
+    tag.closing = content.at(position + 1) == '/';
+    tag.empty = content.at(end - 1) == '/';
+
+    const size_t begin = position + (tag.closing ? 2 : 1);
+    size_t nameEnd = begin;
+    while (nameEnd < end && !isSpace(content.at(nameEnd)) &&
+           content.at(nameEnd) != '/')
+      nameEnd++;
+    tag.name = content.substr(begin, nameEnd - begin);
+
+    position = end + 1;
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * Attribute
+ * @param tag Tag
+ * @param name Attribute name
+ * @param value Attribute value
+ * @return Status
+ */
+bool attribute(const std::string_view &tag, const std::string_view &name,
+               std::string_view &value) {
+  size_t position = 0;
+  while ((position = tag.find(name, position)) != std::string_view::npos) {
+    const size_t end = position + name.size();
+    if (position > 0 && isSpace(tag.at(position - 1)) &&
+        end + 1 < tag.size() && tag.at(end) == '=' &&
+        (tag.at(end + 1) == '"' || tag.at(end + 1) == '\'')) {
+      const size_t close = tag.find(tag.at(end + 1), end + 2);
+      if (close == std::string_view::npos)
+        return false;
+
+      value = tag.substr(end + 2, close - end - 2);
+      return true;
+    }
+    position = end;
+  }
+
+  return false;
+}
+
+} // namespace XML
@@ -0,0 +1,48 @@
+#ifndef _XML_
+#define _XML_
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * XML
+ * Minimal tag scanning over a raw character range, without allocation. Enough
+ * for the VTK XML headers, not a validating parser.
+ */
+namespace XML {
+
+// Tag
+struct Tag {
+  // Name, without the / of closing tags
+  std::string_view name;
+  // Whole tag, from < to >
+  std::string_view text;
+  // </name>
+  bool closing = false;
+  // <name/>
+  bool empty = false;
+};
+
+/**
+ * Next tag
+ * Declarations, processing instructions & comments are skipped
+ * @param content Content
+ * @param position Position, just after the tag on return
+ * @param tag Tag
+ * @return Status, false at the end of content
+ */
+bool nextTag(const std::string_view &, size_t &, Tag &);
+
+/**
+ * Attribute
+ * @param tag Tag
+ * @param name Attribute name
+ * @param value Attribute value, without quotes
+ * @return Status
+ */
+bool attribute(const std::string_view &, const std::string_view &,
+               std::string_view &);
+
+} // namespace XML
+
+#endif // _XML_
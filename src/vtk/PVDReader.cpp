@@ -0,0 +1,96 @@
+#include "PVDReader.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+#include "../logger/Logger.hpp"
+#include "../utils/MappedFile.hpp"
+#include "../utils/Scanner.hpp"
+#include "../utils/xml.hpp"
+
+/**
+ * Constructor
+ */
+PVDReader::PVDReader() = default;
+
+/**
+ * Constructor
+ * @param fileName File name
+ */
+PVDReader::PVDReader(const std::string &fileName) : m_fileName(fileName) {}
+
+/**
+ * Read
+ * Data sets are sorted by time, files are relative to the collection
+ * @return Status
+ */
+bool PVDReader::read() {
+  MappedFile file;
+  if (!file.open(this->m_fileName)) {
+    Logger::ERROR("Unable to open " + this->m_fileName);
+    return false;
+  }
+  const std::string_view content(file.data(), file.size());
+
+  const size_t slash = this->m_fileName.find_last_of('/');
+  const std::string directory = slash == std::string::npos
+                                    ? ""
+                                    : this->m_fileName.substr(0, slash + 1);
+
+  size_t position = 0;
+  XML::Tag dataSetTag;
+  while (XML::nextTag(content, position, dataSetTag)) {
+    if (dataSetTag.closing || dataSetTag.name != "DataSet")
+      continue;
+    const std::string_view &tag = dataSetTag.text;
+
+    // Multi-part collections are not supported
+    std::string_view part;
+    if (XML::attribute(tag, "part", part) && part != "0") {
+      Logger::ERROR("Multi-part collection " + this->m_fileName);
+      return false;
+    }
+
+    std::string_view timestep;
+    std::string_view fileName;
+    if (!XML::attribute(tag, "file", fileName) || fileName.empty()) {
+      Logger::ERROR("Data set without file in " + this->m_fileName);
+      return false;
+    }
+
+    PVDDataSet dataSet;
+    dataSet.time = 0;
+    if (XML::attribute(tag, "timestep", timestep)) {
+      Scanner scanner(timestep.data(), timestep.data() + timestep.size());
+      if (!scanner.read(dataSet.time)) {
+        Logger::ERROR("Invalid timestep in " + this->m_fileName);
+        return false;
+      }
+    }
+    dataSet.file = fileName.front() == '/'
+                       ? std::string(fileName)
+                       : directory + std::string(fileName);
+
+    this->m_dataSets.push_back(dataSet);
+  }
+
+  if (this->m_dataSets.empty()) {
+    Logger::ERROR("No data set in " + this->m_fileName);
+    return false;
+  }
+
+  std::stable_sort(this->m_dataSets.begin(), this->m_dataSets.end(),
+                   [](const PVDDataSet &a, const PVDDataSet &b) {
+                     return a.time < b.time;
+                   });
+
+  return true;
+}
+
+/**
+ * Get data sets
+ * @return Data sets
+ */
+const std::vector<PVDDataSet> &PVDReader::getDataSets() const {
+  return this->m_dataSets;
+}
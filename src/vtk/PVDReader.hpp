@@ -0,0 +1,36 @@
+#ifndef _PVD_READER_
+#define _PVD_READER_
+
+#include <string>
+#include <vector>
+
+// Data set of a collection
+struct PVDDataSet {
+  double time;
+  // File, relative to the working directory
+  std::string file;
+};
+
+/**
+ * PVDReader class
+ * ParaView collection of .vtu / .pvtu time steps
+ */
+class PVDReader {
+private:
+  std::string m_fileName = "";
+  std::vector<PVDDataSet> m_dataSets = std::vector<PVDDataSet>();
+
+public:
+  // Constructor
+  PVDReader();
+  // Constructor
+  explicit PVDReader(const std::string &);
+
+  // Read
+  bool read();
+
+  // Get data sets
+  const std::vector<PVDDataSet> &getDataSets() const;
+};
+
+#endif // _PVD_READER_
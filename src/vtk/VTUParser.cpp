@@ -0,0 +1,742 @@
+#include "VTUParser.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <zlib.h>
+
+#include "../utils/MappedFile.hpp"
+#include "../utils/Scanner.hpp"
+#include "../utils/xml.hpp"
+
+/**
+ * Binary format, from the VTKFile & AppendedData tags
+ */
+struct VTUFormat {
+  // Header integers size, UInt32 or UInt64
+  size_t headerSize = 4;
+  // zlib compressed blocks
+  bool compressed = false;
+  // Appended data, after the _
+  const char *appended = nullptr;
+  const char *appendedEnd = nullptr;
+  // Appended data encoding, raw or base64
+  bool appendedBase64 = false;
+  // File, owner of the appended data
+  std::shared_ptr<const void> file = nullptr;
+};
+
+/**
+ * Bytes, a view over the file or over decoded storage
+ */
+struct VTUBytes {
+  std::shared_ptr<const void> storage = nullptr;
+  const char *data = nullptr;
+  size_t size = 0;
+};
+
+/**
+ * Constructor
+ */
+VTUParser::VTUParser() = default;
+
+/**
+ * Constructor
+ * @param fileName File name
+ */
+VTUParser::VTUParser(const std::string &fileName) : m_fileName(fileName) {}
+
+/**
+ * Set cell data
+ * @param cellData Read the cell data
+ */
+void VTUParser::setCellData(const bool cellData) {
+  this->m_cellData = cellData;
+}
+
+/**
+ * Base64 value
+ * @param c Character
+ * @return Value, -1 if invalid
+ */
+static inline int base64Value(const char c) {
+  if (c >= 'A' && c <= 'Z')
+    return c - 'A';
+  if (c >= 'a' && c <= 'z')
+    return c - 'a' + 26;
+  if (c >= '0' && c <= '9')
+    return c - '0' + 52;
+  if (c == '+')
+    return 62;
+  if (c == '/')
+    return 63;
+  return -1;
+}
+
+/**
+ * Base64 length
+ * @param size Number of bytes
+ * @return Number of characters
+ */
+static inline size_t base64Length(const size_t size) {
+  return (size + 2) / 3 * 4;
+}
+
+/**
+ * Decode base64
+ * @param begin Begin
+ * @param length Number of characters, multiple of 4
+ * @param bytes Decoded bytes, appended
+ * @return Status
+ */
+static bool decodeBase64(const char *begin, const size_t length,
+                         std::vector<char> &bytes) {
+  if (length % 4)
+    return false;
+
+  bytes.reserve(bytes.size() + length / 4 * 3);
+  for (size_t i = 0; i < length; i += 4) {
+    uint32_t word = 0;
+    int padding = 0;
+    for (int k = 0; k < 4; ++k) {
+      const char c = begin[i + k];
+      int value = 0;
+      if (c == '=' && k >= 2) {
+        padding++;
+      } else {
+        value = base64Value(c);
+        if (value < 0 || padding)
+          return false;
+      }
+      word = (word << 6) | (uint32_t)value;
+    }
+
+    bytes.push_back((char)((word >> 16) & 0xff));
+    if (padding < 2)
+      bytes.push_back((char)((word >> 8) & 0xff));
+    if (padding < 1)
+      bytes.push_back((char)(word & 0xff));
+  }
+
+  return true;
+}
+
+/**
+ * Read header integer
+ * @param data Data
+ * @param headerSize Header integer size
+ * @return Value
+ */
+static uint64_t readHeader(const char *data, const size_t headerSize) {
+  if (headerSize == 8) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  }
+
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+/**
+ * Read header
+ * Raw bytes, or base64 characters decoded on the fly
+ * @param begin Begin
+ * @param end End
+ * @param base64 Base64 encoded
+ * @param size Number of header bytes
+ * @param header Header bytes
+ * @return Number of bytes or characters used, 0 on error
+ */
+static size_t readHeaderBytes(const char *begin, const char *end,
+                              const bool base64, const size_t size,
+                              std::vector<char> &header) {
+  const size_t length = base64 ? base64Length(size) : size;
+  if ((size_t)(end - begin) < length)
+    return 0;
+
+  header.clear();
+  if (base64) {
+    if (!decodeBase64(begin, length, header) || header.size() < size)
+      return 0;
+  } else {
+    header.assign(begin, begin + size);
+  }
+
+  return length;
+}
+
+/**
+ * Decode payload
+ * [size][data] if uncompressed, [blocks][block size][last block size]
+ * [compressed sizes][compressed blocks] with zlib. Base64 compressed headers
+ * are encoded on their own.
+ * @param begin Begin
+ * @param end End
+ * @param base64 Base64 encoded
+ * @param format Format
+ * @param bytes Bytes
+ * @return Status
+ */
+static bool decodePayload(const char *begin, const char *end,
+                          const bool base64, const VTUFormat &format,
+                          VTUBytes &bytes) {
+  const size_t headerSize = format.headerSize;
+  std::vector<char> header;
+
+  // Uncompressed
+  if (!format.compressed) {
+    if (!readHeaderBytes(begin, end, base64, headerSize, header))
+      return false;
+    const uint64_t size = readHeader(header.data(), headerSize);
+
+    if (!base64) {
+      if ((uint64_t)(end - begin) - headerSize < size)
+        return false;
+      bytes.storage = format.file;
+      bytes.data = begin + headerSize;
+      bytes.size = (size_t)size;
+      return true;
+    }
+
+    const size_t length = base64Length(headerSize + (size_t)size);
+    if ((size_t)(end - begin) < length)
+      return false;
+    auto decoded = std::make_shared<std::vector<char>>();
+    if (!decodeBase64(begin, length, *decoded) ||
+        decoded->size() < headerSize + size)
+      return false;
+
+    bytes.data = decoded->data() + headerSize;
+    bytes.size = (size_t)size;
+    bytes.storage = decoded;
+    return true;
+  }
+
+  // Compressed header
+  if (!readHeaderBytes(begin, end, base64, 3 * headerSize, header))
+    return false;
+  const uint64_t numberOfBlocks = readHeader(header.data(), headerSize);
+  const uint64_t blockSize = readHeader(header.data() + headerSize, headerSize);
+  const uint64_t lastBlockSize =
+      readHeader(header.data() + 2 * headerSize, headerSize);
+
+  // Untrusted header, bounded by the remaining bytes before any allocation
+  if ((numberOfBlocks && !blockSize) || lastBlockSize > blockSize ||
+      numberOfBlocks > (uint64_t)(end - begin) / headerSize)
+    return false;
+
+  const size_t headerLength = readHeaderBytes(
+      begin, end, base64, (3 + numberOfBlocks) * headerSize, header);
+  if (!headerLength)
+    return false;
+
+  std::vector<uint64_t> compressedSizes(numberOfBlocks);
+  uint64_t compressedSize = 0;
+  for (uint64_t i = 0; i < numberOfBlocks; ++i) {
+    compressedSizes.at(i) =
+        readHeader(header.data() + (3 + i) * headerSize, headerSize);
+    if (compressedSizes.at(i) > (uint64_t)(end - begin))
+      return false;
+    compressedSize += compressedSizes.at(i);
+  }
+  if (compressedSize > (uint64_t)(end - begin))
+    return false;
+
+  // Compressed blocks
+  const char *data = begin + headerLength;
+  std::vector<char> decodedBlocks;
+  if (base64) {
+    const size_t length = base64Length((size_t)compressedSize);
+    if ((size_t)(end - data) < length ||
+        !decodeBase64(data, length, decodedBlocks) ||
+        decodedBlocks.size() < compressedSize)
+      return false;
+    data = decodedBlocks.data();
+  } else if ((uint64_t)(end - data) < compressedSize) {
+    return false;
+  }
+
+  // Inflate, zlib expands at most about 1032:1
+  const uint64_t maxSize = compressedSize * 1032;
+  if (numberOfBlocks > 1 && numberOfBlocks - 1 > maxSize / blockSize)
+    return false;
+  const uint64_t size =
+      numberOfBlocks ? (numberOfBlocks - 1) * blockSize +
+                           (lastBlockSize ? lastBlockSize : blockSize)
+                     : 0;
+  if (size > maxSize)
+    return false;
+  auto inflated = std::make_shared<std::vector<char>>((size_t)size);
+  uint64_t offset = 0;
+  for (uint64_t i = 0; i < numberOfBlocks; ++i) {
+    const uint64_t expected =
+        (i + 1 == numberOfBlocks && lastBlockSize) ? lastBlockSize : blockSize;
+    uLongf length = (uLongf)expected;
+    if (uncompress((Bytef *)inflated->data() + offset, &length,
+                   (const Bytef *)data, (uLong)compressedSizes.at(i)) !=
+            Z_OK ||
+        length != expected)
+      return false;
+
+    data += compressedSizes.at(i);
+    offset += expected;
+  }
+
+  bytes.data = inflated->data();
+  bytes.size = inflated->size();
+  bytes.storage = inflated;
+  return true;
+}
+
+/**
+ * Parse ascii
+ * Float32 arrays are kept as float, other types are read as double
+ * @param text Text
+ * @param type Type, updated to the parsed type
+ * @param bytes Bytes
+ * @return Status
+ */
+static bool parseAscii(const std::string_view &text, std::string_view &type,
+                       VTUBytes &bytes) {
+  Scanner scanner(text.data(), text.data() + text.size());
+
+  if (type == "Float32") {
+    auto values = std::make_shared<std::vector<float>>();
+    double value;
+    while (!scanner.eof()) {
+      if (!scanner.read(value))
+        return false;
+      values->push_back((float)value);
+    }
+    bytes.data = (const char *)values->data();
+    bytes.size = values->size() * sizeof(float);
+    bytes.storage = values;
+    return true;
+  }
+
+  auto values = std::make_shared<std::vector<double>>();
+  double value;
+  while (!scanner.eof()) {
+    if (!scanner.read(value))
+      return false;
+    values->push_back(value);
+  }
+  bytes.data = (const char *)values->data();
+  bytes.size = values->size() * sizeof(double);
+  bytes.storage = values;
+  type = "Float64";
+  return true;
+}
+
+/**
+ * Convert
+ * @param data Data
+ * @param size Number of bytes
+ * @param converted Converted values
+ * @return Status
+ */
+template <typename T, typename U>
+static bool convert(const char *data, const size_t size,
+                    std::vector<U> &converted) {
+  if (size % sizeof(T))
+    return false;
+
+  converted.resize(size / sizeof(T));
+  for (size_t i = 0; i < converted.size(); ++i) {
+    T value;
+    std::memcpy(&value, data + i * sizeof(T), sizeof(T));
+    converted[i] = (U)value;
+  }
+  return true;
+}
+
+/**
+ * Convert
+ * @param type VTK type name
+ * @param bytes Bytes
+ * @param converted Converted values
+ * @return Status, false for unknown types
+ */
+template <typename U>
+static bool convert(const std::string_view &type, const VTUBytes &bytes,
+                    std::vector<U> &converted) {
+  if (type == "Int8")
+    return convert<int8_t>(bytes.data, bytes.size, converted);
+  if (type == "UInt8")
+    return convert<uint8_t>(bytes.data, bytes.size, converted);
+  if (type == "Int16")
+    return convert<int16_t>(bytes.data, bytes.size, converted);
+  if (type == "UInt16")
+    return convert<uint16_t>(bytes.data, bytes.size, converted);
+  if (type == "Int32")
+    return convert<int32_t>(bytes.data, bytes.size, converted);
+  if (type == "UInt32")
+    return convert<uint32_t>(bytes.data, bytes.size, converted);
+  if (type == "Int64")
+    return convert<int64_t>(bytes.data, bytes.size, converted);
+  if (type == "UInt64")
+    return convert<uint64_t>(bytes.data, bytes.size, converted);
+  if (type == "Float32")
+    return convert<float>(bytes.data, bytes.size, converted);
+  if (type == "Float64")
+    return convert<double>(bytes.data, bytes.size, converted);
+  return false;
+}
+
+/**
+ * View
+ * Aligned data is viewed in place, unaligned data is copied
+ * @param bytes Bytes
+ * @param pointer Typed pointer
+ * @param storage Storage
+ * @return Number of values
+ */
+template <typename T>
+static size_t view(const VTUBytes &bytes, const T *&pointer,
+                   std::shared_ptr<const void> &storage) {
+  const size_t count = bytes.size / sizeof(T);
+  if ((uintptr_t)bytes.data % alignof(T) == 0) {
+    pointer = (const T *)bytes.data;
+    storage = bytes.storage;
+  } else {
+    auto copy = std::make_shared<std::vector<T>>(count);
+    std::memcpy(copy->data(), bytes.data, count * sizeof(T));
+    pointer = copy->data();
+    storage = copy;
+  }
+  return count;
+}
+
+/**
+ * To values
+ * Float32 & Float64 are viewed, other types are converted to double
+ * @param type VTK type name
+ * @param bytes Bytes
+ * @param values Values
+ * @return Status
+ */
+static bool toValues(const std::string_view &type, const VTUBytes &bytes,
+                     VTUValues &values) {
+  if (type == "Float32") {
+    if (bytes.size % sizeof(float))
+      return false;
+    values.size = view(bytes, values.floats, values.storage);
+    return true;
+  }
+  if (type == "Float64") {
+    if (bytes.size % sizeof(double))
+      return false;
+    values.size = view(bytes, values.doubles, values.storage);
+    return true;
+  }
+
+  auto converted = std::make_shared<std::vector<double>>();
+  if (!convert(type, bytes, *converted))
+    return false;
+  values.doubles = converted->data();
+  values.size = converted->size();
+  values.storage = converted;
+  return true;
+}
+
+/**
+ * Read size attribute
+ * @param tag Tag
+ * @param name Attribute name
+ * @param value Value
+ * @return Status
+ */
+static bool readSize(const std::string_view &tag, const std::string_view &name,
+                     size_t &value) {
+  std::string_view text;
+  if (!XML::attribute(tag, name, text))
+    return false;
+
+  auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  return error == std::errc() && end == text.data() + text.size();
+}
+
+/**
+ * Read data array
+ * @param tag DataArray tag
+ * @param text DataArray text, for ascii & binary formats
+ * @param format Format
+ * @param section Section, Points, Cells, PointData or CellData
+ * @param piece Piece
+ * @return Status
+ */
+static bool readDataArray(const std::string_view &tag,
+                          const std::string_view &text,
+                          const VTUFormat &format,
+                          const std::string_view &section,
+                          VTUParsedPiece &piece) {
+  std::string_view type;
+  std::string_view dataFormat;
+  std::string_view name;
+  if (!XML::attribute(tag, "type", type) ||
+      !XML::attribute(tag, "format", dataFormat))
+    return false;
+  XML::attribute(tag, "Name", name);
+  size_t numberOfComponents = 1;
+  std::string_view components;
+  if (XML::attribute(tag, "NumberOfComponents", components) &&
+      !readSize(tag, "NumberOfComponents", numberOfComponents))
+    return false;
+
+  // Polyhedra faces are not needed
+  if (section == "Cells" && name != "connectivity" && name != "offsets" &&
+      name != "types")
+    return true;
+
+  // Bytes
+  VTUBytes bytes;
+  if (dataFormat == "ascii") {
+    if (!parseAscii(text, type, bytes))
+      return false;
+  } else if (dataFormat == "binary") {
+    std::string encoded;
+    encoded.reserve(text.size());
+    for (const char c : text)
+      if (!std::isspace((unsigned char)c))
+        encoded.push_back(c);
+    if (!decodePayload(encoded.data(), encoded.data() + encoded.size(), true,
+                       format, bytes))
+      return false;
+  } else if (dataFormat == "appended") {
+    size_t offset;
+    if (!format.appended || !readSize(tag, "offset", offset) ||
+        offset >= (size_t)(format.appendedEnd - format.appended))
+      return false;
+    if (!decodePayload(format.appended + offset, format.appendedEnd,
+                       format.appendedBase64, format, bytes))
+      return false;
+  } else {
+    return false;
+  }
+
+  // Points
+  if (section == "Points")
+    return toValues(type, bytes, piece.points);
+
+  // Cells
+  if (section == "Cells") {
+    if (name == "connectivity")
+      return convert(type, bytes, piece.connectivity);
+    if (name == "types")
+      return convert(type, bytes, piece.types);
+    std::vector<int64_t> offsets;
+    if (!convert(type, bytes, offsets))
+      return false;
+    piece.offsets.insert(piece.offsets.end(), offsets.begin(), offsets.end());
+    return true;
+  }
+
+  // Point & cell data
+  VTUValues values;
+  if (!toValues(type, bytes, values))
+    return false;
+  if (section == "PointData") {
+    piece.names.emplace_back(name);
+    piece.sizes.push_back((int)numberOfComponents);
+    piece.values.push_back(std::move(values));
+  } else {
+    piece.cellNames.emplace_back(name);
+    piece.cellSizes.push_back((int)numberOfComponents);
+    piece.cellValues.push_back(std::move(values));
+  }
+  return true;
+}
+
+/**
+ * Cell size
+ * Same cells as the reader: vertices & lines, surface cells, tetrahedra
+ * @param type VTK cell type
+ * @return Number of points of a fixed size cell read, 0 otherwise
+ */
+static int64_t cellSize(const unsigned char type) {
+  switch (type) {
+  case 1: // VTK_VERTEX
+    return 1;
+  case 3: // VTK_LINE
+    return 2;
+  case 5: // VTK_TRIANGLE
+    return 3;
+  case 8:  // VTK_PIXEL
+  case 9:  // VTK_QUAD
+  case 10: // VTK_TETRA
+    return 4;
+  default: // Poly vertex, poly line, strip & polygon, or skipped
+    return 0;
+  }
+}
+
+/**
+ * Check piece
+ * Sizes and indices are checked, so the cells can be read without bounds
+ * checks
+ * @param piece Piece
+ * @return Status
+ */
+static bool checkPiece(const VTUParsedPiece &piece) {
+  for (size_t i = 0; i < piece.values.size(); ++i)
+    if (piece.values.at(i).size != piece.numberOfPoints * piece.sizes.at(i))
+      return false;
+  for (size_t i = 0; i < piece.cellValues.size(); ++i)
+    if (piece.cellValues.at(i).size !=
+        piece.numberOfCells * piece.cellSizes.at(i))
+      return false;
+
+  if (piece.points.size != 3 * piece.numberOfPoints ||
+      piece.offsets.size() != piece.numberOfCells + 1 ||
+      piece.types.size() != piece.numberOfCells)
+    return false;
+
+  for (size_t i = 0; i < piece.numberOfCells; ++i) {
+    const int64_t size = piece.offsets.at(i + 1) - piece.offsets.at(i);
+    const int64_t expected = cellSize(piece.types.at(i));
+    if (size < 0 || (expected && size != expected))
+      return false;
+  }
+  if (piece.offsets.back() > (int64_t)piece.connectivity.size())
+    return false;
+
+  for (const int64_t index : piece.connectivity)
+    if (index < 0 || (uint64_t)index >= piece.numberOfPoints)
+      return false;
+
+  return true;
+}
+
+/**
+ * Read
+ * Unsupported files (big endian, other compressors, other data sets) return
+ * false, so the caller can fall back to VTK
+ * @return Status
+ */
+bool VTUParser::read() {
+  auto file = std::make_shared<MappedFile>();
+  if (!file->open(this->m_fileName) || !file->size())
+    return false;
+  const std::string_view content(file->data(), file->size());
+
+  VTUFormat format;
+  format.file = file;
+
+  // Appended data, raw bytes can follow, so the XML ends there
+  size_t headerEnd = content.find("<AppendedData");
+  if (headerEnd != std::string_view::npos) {
+    const size_t tagEnd = content.find('>', headerEnd);
+    if (tagEnd == std::string_view::npos)
+      return false;
+    const std::string_view tag =
+        content.substr(headerEnd, tagEnd + 1 - headerEnd);
+
+    std::string_view encoding;
+    if (XML::attribute(tag, "encoding", encoding) && encoding != "raw" &&
+        encoding != "base64")
+      return false;
+    format.appendedBase64 = encoding == "base64";
+
+    const size_t underscore = content.find('_', tagEnd);
+    if (underscore == std::string_view::npos)
+      return false;
+    format.appended = content.data() + underscore + 1;
+    format.appendedEnd = content.data() + content.size();
+  } else {
+    headerEnd = content.size();
+  }
+  const std::string_view header = content.substr(0, headerEnd);
+
+  // Tags
+  size_t position = 0;
+  XML::Tag tag;
+  std::string_view section;
+  VTUParsedPiece *piece = nullptr;
+  bool vtkFile = false;
+  while (XML::nextTag(header, position, tag)) {
+    if (tag.name == "VTKFile") {
+      if (tag.closing)
+        continue;
+      std::string_view value;
+      if (!XML::attribute(tag.text, "type", value) ||
+          value != "UnstructuredGrid")
+        return false;
+      if (XML::attribute(tag.text, "byte_order", value) &&
+          value != "LittleEndian")
+        return false;
+      if (XML::attribute(tag.text, "header_type", value)) {
+        if (value == "UInt64")
+          format.headerSize = 8;
+        else if (value != "UInt32")
+          return false;
+      }
+      if (XML::attribute(tag.text, "compressor", value)) {
+        if (value != "vtkZLibDataCompressor")
+          return false;
+        format.compressed = true;
+      }
+      vtkFile = true;
+    } else if (tag.name == "Piece") {
+      piece = nullptr;
+      if (tag.closing)
+        continue;
+
+      this->m_pieces.emplace_back();
+      this->m_pieces.back().offsets.push_back(0);
+      if (!readSize(tag.text, "NumberOfPoints",
+                    this->m_pieces.back().numberOfPoints) ||
+          !readSize(tag.text, "NumberOfCells",
+                    this->m_pieces.back().numberOfCells))
+        return false;
+      if (!tag.empty)
+        piece = &this->m_pieces.back();
+    } else if (tag.name == "Points" || tag.name == "Cells" ||
+               tag.name == "PointData" || tag.name == "CellData") {
+      if (tag.closing)
+        section = std::string_view();
+      else if (!tag.empty)
+        section = tag.name;
+    } else if (tag.name == "DataArray" && !tag.closing) {
+      // Text, after the child elements
+      std::string_view text;
+      if (!tag.empty) {
+        const size_t close = header.find("</DataArray>", position);
+        if (close == std::string_view::npos)
+          return false;
+        text = header.substr(position, close - position);
+        const size_t child = text.rfind('>');
+        if (child != std::string_view::npos)
+          text = text.substr(child + 1);
+        position = close;
+      }
+
+      if (!piece || section.empty())
+        continue;
+      if (!this->m_cellData && section == "CellData")
+        continue;
+
+      if (!readDataArray(tag.text, text, format, section, *piece))
+        return false;
+    }
+  }
+
+  if (!vtkFile || this->m_pieces.empty())
+    return false;
+
+  for (const VTUParsedPiece &parsed : this->m_pieces)
+    if (!checkPiece(parsed))
+      return false;
+
+  return true;
+}
+
+/**
+ * Get pieces
+ * @return Pieces
+ */
+std::vector<VTUParsedPiece> &VTUParser::getPieces() { return this->m_pieces; }
@@ -0,0 +1,61 @@
+#ifndef _VTU_PARSER_
+#define _VTU_PARSER_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "VTUReader.hpp"
+
+// Parsed piece
+struct VTUParsedPiece {
+  size_t numberOfPoints = 0;
+  size_t numberOfCells = 0;
+  // Coordinates, 3 per point
+  VTUValues points;
+  std::vector<int64_t> connectivity;
+  // Offsets, numberOfCells + 1, from 0
+  std::vector<int64_t> offsets;
+  std::vector<unsigned char> types;
+  // Point data
+  std::vector<std::string> names;
+  std::vector<int> sizes;
+  std::vector<VTUValues> values;
+  // Cell data
+  std::vector<std::string> cellNames;
+  std::vector<int> cellSizes;
+  std::vector<VTUValues> cellValues;
+};
+
+/**
+ * VTUParser class
+ * Native .vtu parser, without VTK. Supports ascii, inline binary and appended
+ * raw or base64 data, uncompressed or zlib compressed, little endian only.
+ * Float32 & Float64 arrays are viewed in place when possible.
+ */
+class VTUParser {
+private:
+  std::string m_fileName = "";
+  // Read the cell data
+  bool m_cellData = true;
+
+  std::vector<VTUParsedPiece> m_pieces = std::vector<VTUParsedPiece>();
+
+public:
+  // Constructor
+  VTUParser();
+  // Constructor
+  explicit VTUParser(const std::string &);
+
+  // Set cell data
+  void setCellData(const bool);
+
+  // Read
+  bool read();
+
+  // Get pieces
+  std::vector<VTUParsedPiece> &getPieces();
+};
+
+#endif // _VTU_PARSER_
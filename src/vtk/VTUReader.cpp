@@ -1,13 +1,30 @@
 #include "VTUReader.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <type_traits>
+#include <unordered_map>
+
+#include <vtkAOSDataArrayTemplate.h>
 #include <vtkCellArray.h>
-#include <vtkIdList.h>
+#include <vtkCellData.h>
+#include <vtkCellType.h>
 #include <vtkPointData.h>
 #include <vtkPoints.h>
+#include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
+#include <vtkXMLPUnstructuredGridReader.h>
+#include <vtkXMLUnstructuredGridReader.h>
 
 #include "../logger/Logger.hpp"
+#include "../utils/IndexMap.hpp"
+#include "../utils/fields.hpp"
 #include "../utils/utils.hpp"
+#include "VTUParser.hpp"
 
 /**
  * Constructor
@@ -20,190 +37,986 @@ VTUReader::VTUReader() = default;
 VTUReader::VTUReader(const std::string &fileName) : m_fileName(fileName) {}
 
 /**
- * Read
- * @return Status
+ * Set weld
+ * @param weld Weld the interface vertices of pieces, or keep one primitive
+ * per piece
  */
-bool VTUReader::read() {
-  // Check
-  if (!this->m_reader->CanReadFile(m_fileName.c_str()))
-    return false;
+void VTUReader::setWeld(const bool weld) { this->m_weld = weld; }
 
-  // Read
-  this->m_reader->SetFileName(m_fileName.c_str());
-  this->m_reader->Update();
+/**
+ * Set cell data
+ * @param cellData Ignore, average at the points, or keep flat per face
+ */
+void VTUReader::setCellData(const CellDataMode cellData) {
+  this->m_cellData = cellData;
+}
 
-  vtkSmartPointer<vtkUnstructuredGrid> output = this->m_reader->GetOutput();
+/**
+ * Set native
+ * @param native Parse .vtu files without VTK when possible
+ */
+void VTUReader::setNative(const bool native) { this->m_native = native; }
 
-  if (output->GetNumberOfPieces() != 1) {
-    Logger::ERROR("Number of pieces != 1");
-    return false;
+/**
+ * Set geometry
+ * The next read only reads the point & cell data, over this geometry
+ * @param geometry Geometry of a previous step, with the same mesh
+ */
+void VTUReader::setGeometry(
+    const std::shared_ptr<const VTUGeometry> &geometry) {
+  this->m_geometry = geometry;
+}
+
+/**
+ * Piece
+ */
+struct VTUPiece {
+  size_t numberOfPoints = 0;
+  size_t numberOfCells = 0;
+  // Fingerprints of the raw points & cells
+  uint64_t pointsFingerprint = 0;
+  uint64_t cellsFingerprint = 0;
+  VTUGeometry geometry;
+  // Number of skipped cells by type
+  std::map<unsigned char, size_t> unsupported;
+  std::vector<std::string> names;
+  std::vector<int> sizes;
+  std::vector<VTUValues> values;
+  std::vector<std::string> cellNames;
+  std::vector<int> cellSizes;
+  std::vector<VTUValues> cellValues;
+};
+
+/**
+ * Vertex key, for welding
+ */
+struct VertexKey {
+  double x;
+  double y;
+  double z;
+
+  bool operator==(const VertexKey &key) const {
+    return this->x == key.x && this->y == key.y && this->z == key.z;
   }
+};
 
-  // Geometry
-  VTUData baseData;
-  baseData.name = "base";
-  baseData.size = 0;
+/**
+ * Vertex key hash
+ */
+struct VertexKeyHash {
+  size_t operator()(const VertexKey &key) const {
+    std::hash<double> hash;
+    size_t seed = hash(key.x);
+    seed ^= hash(key.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= hash(key.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+  }
+};
+
+/**
+ * Cell kind
+ */
+enum class CellKind {
+  // Vertices & lines, read as polylines
+  Polyline,
+  // Surface cells, triangulated
+  Surface,
+  // Tetrahedron
+  Tetrahedron,
+  // Other cells, skipped
+  Unsupported
+};
+
+/**
+ * Cell kind
+ * @param type VTK cell type
+ * @return Kind
+ */
+static CellKind cellKind(const unsigned char type) {
+  switch (type) {
+  case VTK_VERTEX:
+  case VTK_POLY_VERTEX:
+  case VTK_LINE:
+  case VTK_POLY_LINE:
+    return CellKind::Polyline;
+  case VTK_TRIANGLE:
+  case VTK_TRIANGLE_STRIP:
+  case VTK_POLYGON:
+  case VTK_PIXEL:
+  case VTK_QUAD:
+    return CellKind::Surface;
+  case VTK_TETRA:
+    return CellKind::Tetrahedron;
+  default:
+    return CellKind::Unsupported;
+  }
+}
+
+/**
+ * Read cells
+ * Offsets & connectivity are read in place, in their storage type. Surface
+ * cells are triangulated, triangles & tetrahedra are labelled with their cell
+ * index. Vertices & lines are polylines, other cells are skipped and counted
+ * @param offsets Offsets, numberOfCells + 1
+ * @param connectivity Connectivity
+ * @param types Cell types
+ * @param numberOfCells Number of cells
+ * @param geometry Geometry
+ * @param unsupported Number of skipped cells by type
+ */
+template <typename IdT>
+static void readCells(const IdT *offsets, const IdT *connectivity,
+                      const unsigned char *types,
+                      const vtkIdType numberOfCells, VTUGeometry &geometry,
+                      std::map<unsigned char, size_t> &unsupported) {
+  // Count
+  size_t numberOfTriangles = 0;
+  size_t numberOfTetrahedra = 0;
+  size_t numberOfPolylines = 0;
+  size_t numberOfPolylinesIndices = 0;
+  for (vtkIdType i = 0; i < numberOfCells; ++i) {
+    const IdT size = offsets[i + 1] - offsets[i];
+    switch (cellKind(types[i])) {
+    case CellKind::Polyline:
+      numberOfPolylines++;
+      numberOfPolylinesIndices += (size_t)size;
+      break;
+    case CellKind::Surface:
+      numberOfTriangles += size > 2 ? (size_t)size - 2 : 0;
+      break;
+    case CellKind::Tetrahedron:
+      numberOfTetrahedra++;
+      break;
+    case CellKind::Unsupported:
+      unsupported[types[i]]++;
+      break;
+    }
+  }
+  geometry.numberOfCells = (size_t)numberOfCells;
+  geometry.triangles.reserve(numberOfTriangles);
+  geometry.tetrahedra.reserve(numberOfTetrahedra);
+  geometry.polygons.reserve(numberOfPolylines, numberOfPolylinesIndices);
+  geometry.polygonsCells.reserve(numberOfPolylines);
+
+  // Fill
+  for (vtkIdType i = 0; i < numberOfCells; ++i) {
+    const IdT *indices = connectivity + offsets[i];
+    const IdT size = offsets[i + 1] - offsets[i];
+
+    switch (cellKind(types[i])) {
+    case CellKind::Polyline:
+      for (IdT j = 0; j < size; ++j)
+        geometry.polygons.addIndex((uint)indices[j]);
+      geometry.polygons.endPolyline();
+      geometry.polygonsCells.push_back((uint)i);
+      break;
+    case CellKind::Surface:
+      // Fan around the first corner
+      for (IdT j = 1; j + 1 < size; ++j) {
+        IdT corners[3] = {0, j, j + 1};
+        if (types[i] == VTK_PIXEL) {
+          // Corners in the 0 1 3 2 order
+          const IdT order[4] = {0, 1, 3, 2};
+          corners[1] = order[j];
+          corners[2] = order[j + 1];
+        } else if (types[i] == VTK_TRIANGLE_STRIP) {
+          // Every other triangle flipped, to keep the orientation
+          corners[0] = j % 2 ? j - 1 : j;
+          corners[1] = j % 2 ? j : j - 1;
+        }
+        geometry.triangles.emplace_back(
+            (uint)indices[corners[0]], (uint)indices[corners[1]],
+            (uint)indices[corners[2]], (uint)i);
+      }
+      break;
+    case CellKind::Tetrahedron:
+      geometry.tetrahedra.emplace_back((uint)indices[0], (uint)indices[1],
+                                       (uint)indices[2], (uint)indices[3],
+                                       (uint)i);
+      break;
+    case CellKind::Unsupported:
+      break;
+    }
+  }
+}
+
+/**
+ * Fingerprint
+ * FNV-1a over 64 bits words, so that any changed word changes the hash.
+ * Coordinates are hashed as doubles & indices as int64, whatever their
+ * storage type
+ */
+struct Fingerprint {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  /**
+   * Add
+   * @param word Word
+   */
+  inline void add(const uint64_t word) {
+    this->hash = (this->hash ^ word) * 0x100000001b3ULL;
+  }
+
+  /**
+   * Add
+   * @param value Value
+   */
+  inline void add(const double value) {
+    uint64_t word;
+    std::memcpy(&word, &value, sizeof(word));
+    this->add(word);
+  }
+};
+
+/**
+ * Points fingerprint
+ * @param coordinates Coordinates, 3 per point
+ * @param numberOfPoints Number of points
+ * @return Fingerprint
+ */
+template <typename T>
+static uint64_t pointsFingerprint(const T *coordinates,
+                                  const vtkIdType numberOfPoints) {
+  Fingerprint fingerprint;
+  for (vtkIdType i = 0; i < 3 * numberOfPoints; ++i)
+    fingerprint.add((double)coordinates[i]);
+  return fingerprint.hash;
+}
+
+/**
+ * Points fingerprint
+ * @param points Points
+ * @return Fingerprint
+ */
+static uint64_t pointsFingerprint(vtkPoints *points) {
+  const vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  vtkDataArray *data = points->GetData();
+
+  if (auto *floats = vtkAOSDataArrayTemplate<float>::FastDownCast(data))
+    return pointsFingerprint(floats->GetPointer(0), numberOfPoints);
+  if (auto *doubles = vtkAOSDataArrayTemplate<double>::FastDownCast(data))
+    return pointsFingerprint(doubles->GetPointer(0), numberOfPoints);
+
+  Fingerprint fingerprint;
+  for (vtkIdType i = 0; i < numberOfPoints; ++i) {
+    const double *point = points->GetPoint(i);
+    fingerprint.add(point[0]);
+    fingerprint.add(point[1]);
+    fingerprint.add(point[2]);
+  }
+  return fingerprint.hash;
+}
+
+/**
+ * Cells fingerprint
+ * @param offsets Offsets, numberOfCells + 1
+ * @param connectivity Connectivity
+ * @param types Cell types
+ * @param numberOfCells Number of cells
+ * @return Fingerprint
+ */
+template <typename IdT>
+static uint64_t cellsFingerprint(const IdT *offsets, const IdT *connectivity,
+                                 const unsigned char *types,
+                                 const vtkIdType numberOfCells) {
+  Fingerprint fingerprint;
+  for (vtkIdType i = 0; i < numberOfCells; ++i) {
+    fingerprint.add((uint64_t)types[i]);
+    fingerprint.add((uint64_t)(offsets[i + 1] - offsets[i]));
+  }
+  for (IdT j = 0; j < offsets[numberOfCells]; ++j)
+    fingerprint.add((uint64_t)connectivity[j]);
+  return fingerprint.hash;
+}
+
+/**
+ * Read points
+ * @param coordinates Coordinates, 3 per point
+ * @param numberOfPoints Number of points
+ * @param vertices Vertices
+ */
+template <typename T>
+static void readPoints(const T *coordinates, const vtkIdType numberOfPoints,
+                       std::vector<Vertex> &vertices) {
+  vertices.reserve(numberOfPoints);
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+    vertices.emplace_back(coordinates[3 * i + 0], coordinates[3 * i + 1],
+                          coordinates[3 * i + 2]);
+}
+
+/**
+ * Read points
+ * float & double points are read in place
+ * @param points Points
+ * @param vertices Vertices
+ */
+static void readPoints(vtkPoints *points, std::vector<Vertex> &vertices) {
+  const vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  vtkDataArray *data = points->GetData();
+
+  if (auto *floats = vtkAOSDataArrayTemplate<float>::FastDownCast(data)) {
+    readPoints(floats->GetPointer(0), numberOfPoints, vertices);
+  } else if (auto *doubles =
+                 vtkAOSDataArrayTemplate<double>::FastDownCast(data)) {
+    readPoints(doubles->GetPointer(0), numberOfPoints, vertices);
+  } else {
+    vertices.reserve(numberOfPoints);
+    for (vtkIdType i = 0; i < numberOfPoints; ++i) {
+      const double *point = points->GetPoint(i);
+      vertices.emplace_back(point[0], point[1], point[2]);
+    }
+  }
+}
+
+/**
+ * Read values
+ * float & double arrays are viewed in place, other types are converted to
+ * double
+ * @param array Array
+ * @return Values
+ */
+static VTUValues readValues(const vtkSmartPointer<vtkDataArray> &array) {
+  const vtkIdType numberOfTuples = array->GetNumberOfTuples();
+  const int numberOfComponents = array->GetNumberOfComponents();
+
+  VTUValues values;
+  values.size = (size_t)numberOfTuples * numberOfComponents;
+
+  if (auto *floats = vtkAOSDataArrayTemplate<float>::FastDownCast(array)) {
+    values.floats = floats->GetPointer(0);
+    values.storage =
+        std::shared_ptr<const void>(values.floats, [array](const void *) {});
+  } else if (auto *doubles =
+                 vtkAOSDataArrayTemplate<double>::FastDownCast(array)) {
+    values.doubles = doubles->GetPointer(0);
+    values.storage =
+        std::shared_ptr<const void>(values.doubles, [array](const void *) {});
+  } else {
+    auto converted = std::make_shared<std::vector<double>>(values.size);
+    for (vtkIdType j = 0; j < numberOfTuples; ++j)
+      for (int k = 0; k < numberOfComponents; ++k)
+        converted->at(j * numberOfComponents + k) = array->GetComponent(j, k);
+
+    values.doubles = converted->data();
+    values.storage = converted;
+  }
+
+  return values;
+}
+
+/**
+ * Read piece
+ * The points & cells are always fingerprinted, only read without a geometry
+ * @param output Piece output
+ * @param geometry Read geometry
+ * @param cellData Read cell data
+ * @param piece Piece
+ */
+static void readPiece(vtkUnstructuredGrid *output, const bool geometry,
+                      const bool cellData, VTUPiece &piece) {
+  piece.numberOfPoints = (size_t)output->GetNumberOfPoints();
+  piece.numberOfCells = (size_t)output->GetNumberOfCells();
 
   // Vertices
   vtkSmartPointer<vtkPoints> points = output->GetPoints();
-  const auto numberOfPoints = (int)points->GetNumberOfPoints();
-  for (int i = 0; i < numberOfPoints; ++i) {
-    const double *point = points->GetPoint(i);
-    Vertex v(point[0], point[1], point[2]);
-    baseData.vertices.push_back(v);
+  if (points) {
+    piece.pointsFingerprint = pointsFingerprint(points);
+    if (geometry)
+      readPoints(points, piece.geometry.vertices);
   }
 
   // Indices
   vtkSmartPointer<vtkCellArray> connectivity = output->GetCells();
-  const auto numberOfCells = (int)connectivity->GetNumberOfCells();
-  for (int i = 0; i < numberOfCells; ++i) {
-    auto cellSize = connectivity->GetCellSize(i);
-
-    vtkSmartPointer<vtkIdList> indices = vtkSmartPointer<vtkIdList>::New();
-    connectivity->GetCellAtId(i, indices);
-
-    if (cellSize == 3) { // Triangle
-      Triangle triangle;
-
-      const auto index1 = (int)indices->GetId(0);
-      triangle.setI1(index1);
-      const auto index2 = (int)indices->GetId(1);
-      triangle.setI2(index2);
-      const auto index3 = (int)indices->GetId(2);
-      triangle.setI3(index3);
-
-      baseData.triangles.push_back(triangle);
-    } else if (cellSize == 4) { // Tetrahedron
-      Tetrahedron tetrahedron;
-
-      const auto index1 = (int)indices->GetId(0);
-      tetrahedron.setI1(index1);
-      const auto index2 = (int)indices->GetId(1);
-      tetrahedron.setI2(index2);
-      const auto index3 = (int)indices->GetId(2);
-      tetrahedron.setI3(index3);
-      const auto index4 = (int)indices->GetId(3);
-      tetrahedron.setI4(index4);
-
-      baseData.tetrahedra.push_back(tetrahedron);
+  if (connectivity) {
+    const vtkIdType numberOfCells = connectivity->GetNumberOfCells();
+    const unsigned char *types = output->GetCellTypesArray()->GetPointer(0);
+    if (connectivity->IsStorage64Bit()) {
+      const auto *offsets = connectivity->GetOffsetsArray64()->GetPointer(0);
+      const auto *indices =
+          connectivity->GetConnectivityArray64()->GetPointer(0);
+      piece.cellsFingerprint =
+          cellsFingerprint(offsets, indices, types, numberOfCells);
+      if (geometry)
+        readCells(offsets, indices, types, numberOfCells, piece.geometry,
+                  piece.unsupported);
     } else {
-      Polygon polygon;
-
-      for (int j = 0; j < cellSize; ++j) {
-        polygon.addIndex((int)indices->GetId(j));
-      }
-
-      baseData.polygons.push_back(polygon);
+      const auto *offsets = connectivity->GetOffsetsArray32()->GetPointer(0);
+      const auto *indices =
+          connectivity->GetConnectivityArray32()->GetPointer(0);
+      piece.cellsFingerprint =
+          cellsFingerprint(offsets, indices, types, numberOfCells);
+      if (geometry)
+        readCells(offsets, indices, types, numberOfCells, piece.geometry,
+                  piece.unsupported);
     }
   }
 
   // Point data
   vtkSmartPointer<vtkPointData> pointData = output->GetPointData();
   const int numberOfPointData = pointData->GetNumberOfArrays();
-
   for (int i = 0; i < numberOfPointData; ++i) {
-    VTUData data = baseData;
-    data.name = pointData->GetArrayName(i);
-
     vtkSmartPointer<vtkDataArray> array = pointData->GetArray(i);
-    const auto numberOfValues = (int)array->GetNumberOfValues();
-    const int numberOfComponents = array->GetNumberOfComponents();
-    data.size = numberOfComponents;
+    piece.names.push_back(pointData->GetArrayName(i));
+    piece.sizes.push_back(array->GetNumberOfComponents());
+    piece.values.push_back(readValues(array));
+  }
 
-    const int numberOfTuples = numberOfValues / numberOfComponents;
+  // Cell data
+  if (!cellData)
+    return;
+  vtkSmartPointer<vtkCellData> cells = output->GetCellData();
+  const int numberOfCellData = cells->GetNumberOfArrays();
+  for (int i = 0; i < numberOfCellData; ++i) {
+    vtkSmartPointer<vtkDataArray> array = cells->GetArray(i);
+    piece.cellNames.push_back(cells->GetArrayName(i));
+    piece.cellSizes.push_back(array->GetNumberOfComponents());
+    piece.cellValues.push_back(readValues(array));
+  }
+}
 
-    for (int j = 0; j < numberOfTuples; ++j) {
-      const double *values = array->GetTuple(j);
+/**
+ * Merge pieces geometry
+ * A vertex is only welded to a vertex of an earlier piece at the same
+ * position, the duplicates inside a piece (crack faces, discontinuous fields)
+ * are kept apart
+ * @param pieces Pieces
+ * @param weld Weld the interface vertices
+ * @param geometry Geometry
+ */
+static void mergeGeometry(const std::vector<VTUPiece> &pieces,
+                          const bool weld, VTUGeometry &geometry) {
+  // Merged index & last piece using it, for each position
+  std::unordered_map<VertexKey, std::pair<uint, size_t>, VertexKeyHash> welded;
+  std::vector<std::vector<uint>> &remaps = geometry.remaps;
+  uint cellOffset = 0;
 
-      for (int k = 0; k < numberOfComponents; ++k)
-        data.values.push_back(values[k]);
+  remaps.resize(pieces.size());
+  for (size_t p = 0; p < pieces.size(); ++p) {
+    const VTUGeometry &piece = pieces.at(p).geometry;
+    std::vector<uint> &remap = remaps.at(p);
+
+    // Vertices
+    remap.reserve(piece.vertices.size());
+    std::for_each(
+        piece.vertices.begin(), piece.vertices.end(),
+        [p, weld, &geometry, &remap, &welded](const Vertex &vertex) {
+          const auto index = (uint)geometry.vertices.size();
+          if (weld) {
+            auto [entry, inserted] = welded.try_emplace(
+                VertexKey{vertex.X(), vertex.Y(), vertex.Z()}, index, p);
+            if (!inserted && entry->second.second < p) {
+              // Interface vertex, once per piece
+              entry->second.second = p;
+              remap.push_back(entry->second.first);
+              return;
+            }
+            remap.push_back(index);
+          } else {
+            remap.push_back(index);
+          }
+          geometry.vertices.push_back(vertex);
+        });
+
+    // Elements
+    if (!weld) {
+      geometry.trianglesPieces.push_back(geometry.triangles.size());
+      geometry.tetrahedraPieces.push_back(geometry.tetrahedra.size());
+    }
+    std::for_each(piece.triangles.begin(), piece.triangles.end(),
+                  [&geometry, &remap, cellOffset](const Triangle &triangle) {
+                    geometry.triangles.emplace_back(
+                        remap.at(triangle.I1()), remap.at(triangle.I2()),
+                        remap.at(triangle.I3()), cellOffset + triangle.Label());
+                  });
+    std::for_each(
+        piece.tetrahedra.begin(), piece.tetrahedra.end(),
+        [&geometry, &remap, cellOffset](const Tetrahedron &tetrahedron) {
+          geometry.tetrahedra.emplace_back(
+              remap.at(tetrahedron.I1()), remap.at(tetrahedron.I2()),
+              remap.at(tetrahedron.I3()), remap.at(tetrahedron.I4()),
+              cellOffset + tetrahedron.Label());
+        });
+    const std::vector<uint> &offsets = piece.polygons.getOffsets();
+    const std::vector<uint> &indices = piece.polygons.getIndices();
+    for (size_t i = 0; i < piece.polygons.size(); ++i) {
+      for (uint j = offsets[i]; j < offsets[i + 1]; ++j)
+        geometry.polygons.addIndex(remap.at(indices[j]));
+      geometry.polygons.endPolyline();
+      geometry.polygonsCells.push_back(cellOffset +
+                                       piece.polygonsCells.at(i));
+    }
+
+    cellOffset += (uint)piece.numberOfCells;
+    geometry.numberOfCells += piece.numberOfCells;
+  }
+  if (!weld) {
+    geometry.trianglesPieces.push_back(geometry.triangles.size());
+    geometry.tetrahedraPieces.push_back(geometry.tetrahedra.size());
+  }
+}
+
+/**
+ * Merge pieces values
+ * Point values are remapped, cell values are concatenated
+ * @param pieces Pieces
+ * @param cell Cell data
+ * @param array Array index
+ * @param remaps Merged index of each piece vertex
+ * @param count Number of merged points or cells
+ * @return Merged values
+ */
+template <typename T>
+static VTUValues mergeValues(const std::vector<VTUPiece> &pieces,
+                             const bool cell, const size_t array,
+                             const std::vector<std::vector<uint>> &remaps,
+                             const size_t count) {
+  const int size = (cell ? pieces.front().cellSizes : pieces.front().sizes)
+                       .at(array);
+  auto merged = std::make_shared<std::vector<T>>(count * size);
+
+  size_t offset = 0;
+  for (size_t p = 0; p < pieces.size(); ++p) {
+    const VTUValues &values =
+        (cell ? pieces.at(p).cellValues : pieces.at(p).values).at(array);
+    const std::vector<uint> &remap = remaps.at(p);
+    const size_t numberOfTuples = values.size / size;
+    for (size_t i = 0; i < numberOfTuples; ++i) {
+      const size_t index = cell ? offset + i : remap.at(i);
+      for (int k = 0; k < size; ++k)
+        merged->at((size_t)size * index + k) =
+            (T)values.at((size_t)size * i + k);
     }
+    offset += numberOfTuples;
+  }
+
+  VTUValues values;
+  values.size = merged->size();
+  if constexpr (std::is_same_v<T, float>)
+    values.floats = merged->data();
+  else
+    values.doubles = merged->data();
+  values.storage = merged;
+
+  return values;
+}
+
+/**
+ * Same geometry
+ * The number of points & cells, then the points & cells fingerprints of each
+ * piece are compared
+ * @param pieces Pieces
+ * @param geometry Geometry of a previous step
+ * @return Status
+ */
+static bool sameGeometry(const std::vector<VTUPiece> &pieces,
+                         const VTUGeometry &geometry) {
+  size_t cells = 0;
+  for (const VTUPiece &piece : pieces)
+    cells += piece.numberOfCells;
+  if (cells != geometry.numberOfCells)
+    return false;
+
+  if (pieces.size() == 1) {
+    if (!geometry.remaps.empty() ||
+        pieces.front().numberOfPoints != geometry.vertices.size())
+      return false;
+  } else {
+    if (pieces.size() != geometry.remaps.size())
+      return false;
+    for (size_t p = 0; p < pieces.size(); ++p)
+      if (pieces.at(p).numberOfPoints != geometry.remaps.at(p).size())
+        return false;
+  }
 
-    this->m_arrays.push_back(data);
+  if (geometry.cellsFingerprints.size() != pieces.size() ||
+      geometry.pointsFingerprints.size() != pieces.size())
+    return false;
+  for (size_t p = 0; p < pieces.size(); ++p) {
+    if (pieces.at(p).cellsFingerprint != geometry.cellsFingerprints.at(p))
+      return false;
+    if (pieces.at(p).pointsFingerprint != geometry.pointsFingerprints.at(p)) {
+      Logger::ERROR("Points moved, moving meshes are not supported");
+      return false;
+    }
   }
 
   return true;
 }
 
 /**
- * Get arrays
- * @return Arrays
+ * Merge pieces data
+ * @param pieces Pieces
+ * @param cell Cell data
+ * @param array Array index
+ * @param geometry Merged geometry
+ * @return Data
  */
-std::vector<VTUData> VTUReader::getArrays() const { return this->m_arrays; }
+static VTUData mergeData(const std::vector<VTUPiece> &pieces, const bool cell,
+                         const size_t array,
+                         const std::shared_ptr<const VTUGeometry> &geometry) {
+  const VTUPiece &front = pieces.front();
+
+  VTUData data;
+  data.name = (cell ? front.cellNames : front.names).at(array);
+  data.size = (cell ? front.cellSizes : front.sizes).at(array);
+  data.cell = cell;
+  data.geometry = geometry;
+
+  if (pieces.size() == 1) {
+    data.values = (cell ? front.cellValues : front.values).at(array);
+    return data;
+  }
+
+  // Float if all pieces are
+  const bool floats = std::all_of(
+      pieces.begin(), pieces.end(), [cell, array](const VTUPiece &piece) {
+        return (cell ? piece.cellValues : piece.values).at(array).floats !=
+               nullptr;
+      });
+  const size_t count =
+      cell ? geometry->numberOfCells : geometry->vertices.size();
+  const std::vector<std::vector<uint>> &remaps = geometry->remaps;
+  data.values =
+      floats ? mergeValues<float>(pieces, cell, array, remaps, count)
+             : mergeValues<double>(pieces, cell, array, remaps, count);
+
+  return data;
+}
 
 /**
- * Add vertex
- * @param index Index
- * @param data Data
- * @param vertices Vertices
- * @param values Values
- * @return New index
- */
-uint addVertex(uint index, const VTUData &data, std::vector<Vertex> &vertices,
-               std::vector<double> &values) {
-  const auto newIndex = (uint)vertices.size();
-  vertices.push_back(data.vertices.at(index));
-
-  if (data.size == 1) {
-    values.push_back(data.values.at(index));
-  } else if (data.size == 3) {
-    values.push_back(data.values.at(3 * index + 0));
-    values.push_back(data.values.at(3 * index + 1));
-    values.push_back(data.values.at(3 * index + 2));
+ * Average cell values at the points
+ * One pass over the cells, each point gets the mean of its cells
+ * @param geometry Geometry
+ * @param values Cell values
+ * @param size Number of components
+ * @return Point values
+ */
+static VTUValues averageValues(const VTUGeometry &geometry,
+                               const VTUValues &values, const int size) {
+  const size_t numberOfVertices = geometry.vertices.size();
+  auto sums = std::make_shared<std::vector<double>>(numberOfVertices * size);
+  std::vector<uint> counts(numberOfVertices);
+
+  const auto add = [&values, size, &sums, &counts](const uint vertex,
+                                                    const uint cell) {
+    for (int k = 0; k < size; ++k)
+      (*sums)[(size_t)size * vertex + k] += values.at((size_t)size * cell + k);
+    counts[vertex]++;
+  };
+
+  std::for_each(geometry.triangles.begin(), geometry.triangles.end(),
+                [&add](const Triangle &triangle) {
+                  add(triangle.I1(), triangle.Label());
+                  add(triangle.I2(), triangle.Label());
+                  add(triangle.I3(), triangle.Label());
+                });
+  std::for_each(geometry.tetrahedra.begin(), geometry.tetrahedra.end(),
+                [&add](const Tetrahedron &tetrahedron) {
+                  add(tetrahedron.I1(), tetrahedron.Label());
+                  add(tetrahedron.I2(), tetrahedron.Label());
+                  add(tetrahedron.I3(), tetrahedron.Label());
+                  add(tetrahedron.I4(), tetrahedron.Label());
+                });
+  const std::vector<uint> &offsets = geometry.polygons.getOffsets();
+  const std::vector<uint> &indices = geometry.polygons.getIndices();
+  for (size_t i = 0; i < geometry.polygons.size(); ++i)
+    for (uint j = offsets[i]; j < offsets[i + 1]; ++j)
+      add(indices[j], geometry.polygonsCells.at(i));
+
+  for (size_t i = 0; i < numberOfVertices; ++i)
+    if (counts[i])
+      for (int k = 0; k < size; ++k)
+        (*sums)[(size_t)size * i + k] /= counts[i];
+
+  VTUValues averaged;
+  averaged.size = sums->size();
+  averaged.doubles = sums->data();
+  averaged.storage = sums;
+
+  return averaged;
+}
+
+/**
+ * Read pieces
+ * Each piece is read on its own thread. With a geometry already set, only the
+ * point & cell data are read, the points & cells are only fingerprinted
+ * @return Status
+ */
+template <typename ReaderT> bool VTUReader::readPieces() {
+  vtkSmartPointer<ReaderT> reader = vtkSmartPointer<ReaderT>::New();
+
+  // Check
+  if (!reader->CanReadFile(this->m_fileName.c_str()))
+    return false;
+
+  reader->SetFileName(this->m_fileName.c_str());
+  reader->UpdateInformation();
+  const int numberOfPieces = std::max(1, reader->GetNumberOfPieces());
+
+  // Read
+  const std::shared_ptr<const VTUGeometry> reused = this->m_geometry;
+  std::vector<VTUPiece> pieces(numberOfPieces);
+  Utils::parallelFor(pieces.size(), [this, numberOfPieces, &reused,
+                                     &pieces](const size_t piece) {
+    vtkSmartPointer<ReaderT> pieceReader = vtkSmartPointer<ReaderT>::New();
+    pieceReader->SetFileName(this->m_fileName.c_str());
+    pieceReader->UpdatePiece((int)piece, numberOfPieces, 0);
+
+    readPiece(pieceReader->GetOutput(), !reused,
+              this->m_cellData != CellDataMode::Ignore, pieces.at(piece));
+  });
+
+  return this->mergePieces(pieces);
+}
+
+/**
+ * Read native
+ * .vtu files parsed without VTK, see VTUParser. With a geometry already set,
+ * the points & cells are only fingerprinted
+ * @return Status, false if the file is not supported
+ */
+bool VTUReader::readNative() {
+  const std::shared_ptr<const VTUGeometry> reused = this->m_geometry;
+
+  VTUParser parser(this->m_fileName);
+  parser.setCellData(this->m_cellData != CellDataMode::Ignore);
+  if (!parser.read())
+    return false;
+
+  // Pieces
+  std::vector<VTUParsedPiece> &parsed = parser.getPieces();
+  std::vector<VTUPiece> pieces(parsed.size());
+  Utils::parallelFor(pieces.size(), [&reused, &parsed,
+                                     &pieces](const size_t p) {
+    VTUParsedPiece &parsedPiece = parsed.at(p);
+    VTUPiece &piece = pieces.at(p);
+    piece.numberOfPoints = parsedPiece.numberOfPoints;
+    piece.numberOfCells = parsedPiece.numberOfCells;
+
+    const VTUValues &points = parsedPiece.points;
+    piece.pointsFingerprint =
+        points.floats
+            ? pointsFingerprint(points.floats,
+                                (vtkIdType)parsedPiece.numberOfPoints)
+            : pointsFingerprint(points.doubles,
+                                (vtkIdType)parsedPiece.numberOfPoints);
+    piece.cellsFingerprint = cellsFingerprint(
+        parsedPiece.offsets.data(), parsedPiece.connectivity.data(),
+        parsedPiece.types.data(), (vtkIdType)parsedPiece.numberOfCells);
+
+    if (!reused) {
+      if (points.floats)
+        readPoints(points.floats, (vtkIdType)parsedPiece.numberOfPoints,
+                   piece.geometry.vertices);
+      else if (points.doubles)
+        readPoints(points.doubles, (vtkIdType)parsedPiece.numberOfPoints,
+                   piece.geometry.vertices);
+      readCells(parsedPiece.offsets.data(), parsedPiece.connectivity.data(),
+                parsedPiece.types.data(),
+                (vtkIdType)parsedPiece.numberOfCells, piece.geometry,
+                piece.unsupported);
+    }
+
+    piece.names = std::move(parsedPiece.names);
+    piece.sizes = std::move(parsedPiece.sizes);
+    piece.values = std::move(parsedPiece.values);
+    piece.cellNames = std::move(parsedPiece.cellNames);
+    piece.cellSizes = std::move(parsedPiece.cellSizes);
+    piece.cellValues = std::move(parsedPiece.cellValues);
+  });
+
+  return this->mergePieces(pieces);
+}
+
+/**
+ * Merge pieces
+ * With a geometry already set, only the point & cell data are merged
+ * @param pieces Pieces
+ * @return Status
+ */
+bool VTUReader::mergePieces(std::vector<VTUPiece> &pieces) {
+  const std::shared_ptr<const VTUGeometry> reused = this->m_geometry;
+
+  // Same point & cell data in all pieces
+  for (const VTUPiece &piece : pieces)
+    if (piece.names != pieces.front().names ||
+        piece.sizes != pieces.front().sizes ||
+        piece.cellNames != pieces.front().cellNames ||
+        piece.cellSizes != pieces.front().cellSizes) {
+      Logger::ERROR("Pieces with different point or cell data");
+      return false;
+    }
+
+  // Geometry
+  std::shared_ptr<const VTUGeometry> geometry = reused;
+  if (reused) {
+    if (!sameGeometry(pieces, *reused)) {
+      Logger::ERROR("Geometry different from the previous step");
+      return false;
+    }
+  } else {
+    auto merged = std::make_shared<VTUGeometry>();
+    if (pieces.size() == 1)
+      *merged = std::move(pieces.front().geometry);
+    else
+      mergeGeometry(pieces, this->m_weld, *merged);
+    std::map<unsigned char, size_t> unsupported;
+    for (const VTUPiece &piece : pieces) {
+      merged->pointsFingerprints.push_back(piece.pointsFingerprint);
+      merged->cellsFingerprints.push_back(piece.cellsFingerprint);
+      for (const auto &[type, count] : piece.unsupported)
+        unsupported[type] += count;
+    }
+    for (const auto &[type, count] : unsupported)
+      Logger::ERROR("Unsupported cell type: " + std::to_string(type) + " (" +
+                    std::to_string(count) + " cells)");
+    geometry = merged;
+  }
+  this->m_geometry = geometry;
+
+  // Point data
+  for (size_t i = 0; i < pieces.front().names.size(); ++i)
+    this->m_arrays.push_back(mergeData(pieces, false, i, geometry));
+
+  // Cell data
+  for (size_t i = 0; i < pieces.front().cellNames.size(); ++i) {
+    VTUData data = mergeData(pieces, true, i, geometry);
+    if (this->m_cellData == CellDataMode::Average) {
+      data.values = averageValues(*geometry, data.values, data.size);
+      data.cell = false;
+    }
+
+    this->m_arrays.push_back(std::move(data));
+  }
+
+  return true;
+}
+
+/**
+ * Read
+ * .pvtu files are read with the parallel reader, pieces are welded unless
+ * setWeld(false). With setNative(true), .vtu files are parsed without VTK
+ * first, VTK remains the fallback for unsupported files
+ * @return Status
+ */
+bool VTUReader::read() {
+  const std::string extension = ".pvtu";
+  const bool parallel =
+      this->m_fileName.size() >= extension.size() &&
+      this->m_fileName.compare(this->m_fileName.size() - extension.size(),
+                               extension.size(), extension) == 0;
+
+  if (!parallel && this->m_native) {
+    if (this->readNative())
+      return true;
+    Logger::DEBUG("Native reader unable to read " + this->m_fileName +
+                  ", fall back to VTK");
   }
 
-  return newIndex;
+  if (parallel)
+    return this->readPieces<vtkXMLPUnstructuredGridReader>();
+  return this->readPieces<vtkXMLUnstructuredGridReader>();
+}
+
+/**
+ * Get geometry
+ * @return Geometry, shared by all arrays
+ */
+std::shared_ptr<const VTUGeometry> VTUReader::getGeometry() const {
+  return this->m_geometry;
 }
 
+/**
+ * Get arrays
+ * @return Arrays
+ */
+const std::vector<VTUData> &VTUReader::getArrays() const {
+  return this->m_arrays;
+}
+
+/**
+ * Vertex map
+ * Original vertex to compacted vertex. With flat cell data, a vertex is split
+ * once per class of cells around it
+ */
+struct VertexMap {
+  // Compacted indices, without classes
+  IndexMap indices;
+  // Class of each cell, empty without flat cell data
+  const std::vector<uint> &classes;
+  // Compacted indices, by vertex & class
+  std::unordered_map<uint64_t, uint> split;
+
+  VertexMap(const uint numberOfVertices, const std::vector<uint> &classes)
+      : indices(numberOfVertices), classes(classes) {}
+
+  uint insert(const uint index, const uint cell, bool &inserted) {
+    if (this->classes.empty())
+      return this->indices.insert(index, inserted);
+
+    const uint64_t key =
+        ((uint64_t)index << 32) | (uint64_t)this->classes.at(cell);
+    auto [entry, isNew] =
+        this->split.try_emplace(key, (uint)this->split.size());
+    inserted = isNew;
+    return entry->second;
+  }
+};
+
 /**
  * Index job
  * @param index Index
- * @param data Data
+ * @param cell Cell
+ * @param geometry Geometry
  * @param vertices Vertices
- * @param values Values
+ * @param ids Original indices
+ * @param cells Cells, with flat cell data only
  * @param indices Indices
  * @param set Set function
  */
 template <typename FuncT>
-void indexJob(const uint index, const VTUData &data,
-              std::vector<Vertex> &vertices, std::vector<double> &values,
-              std::vector<std::pair<uint, uint>> &indices, FuncT set) {
-  const auto find = Utils::findIndex(index, indices);
-  if (find == -1) {
-    const auto newIndex = addVertex(index, data, vertices, values);
-    set(newIndex);
-    indices.push_back({index, newIndex});
-  } else {
-    set(find);
+void indexJob(const uint index, const uint cell, const VTUGeometry &geometry,
+              std::vector<Vertex> &vertices, std::vector<uint> &ids,
+              std::vector<uint> &cells, VertexMap &indices, FuncT set) {
+  bool inserted;
+  const uint newIndex = indices.insert(index, cell, inserted);
+  if (inserted) {
+    vertices.push_back(geometry.vertices.at(index));
+    ids.push_back(index);
+    if (!indices.classes.empty())
+      cells.push_back(cell);
   }
+  set(newIndex);
 }
 
 /**
  * Triangle job
- * @param data Data
- * @param triangle Triangle
+ * @param geometry Geometry
+ * @param triangle Triangle, labelled with its cell
  * @param triangles Triangles
  * @param vertices Vertices
- * @param values Values
+ * @param ids Original indices
+ * @param cells Cells, with flat cell data only
  * @param indices Indices
  */
-void triangleJob(const VTUData &data, const Triangle triangle,
+void triangleJob(const VTUGeometry &geometry, const Triangle triangle,
                  std::vector<Triangle> &triangles,
-                 std::vector<Vertex> &vertices, std::vector<double> &values,
-                 std::vector<std::pair<uint, uint>> &indices) {
+                 std::vector<Vertex> &vertices, std::vector<uint> &ids,
+                 std::vector<uint> &cells, VertexMap &indices) {
   const uint index1 = triangle.I1();
   const uint index2 = triangle.I2();
   const uint index3 = triangle.I3();
+  const uint cell = triangle.Label();
 
   Triangle newTriangle;
 
-  indexJob(index1, data, vertices, values, indices,
+  indexJob(index1, cell, geometry, vertices, ids, cells, indices,
            [&newTriangle](uint index) { newTriangle.setI1(index); });
 
-  indexJob(index2, data, vertices, values, indices,
+  indexJob(index2, cell, geometry, vertices, ids, cells, indices,
            [&newTriangle](uint index) { newTriangle.setI2(index); });
 
-  indexJob(index3, data, vertices, values, indices,
+  indexJob(index3, cell, geometry, vertices, ids, cells, indices,
            [&newTriangle](uint index) { newTriangle.setI3(index); });
 
   triangles.push_back(newTriangle);
@@ -211,116 +1024,285 @@ void triangleJob(const VTUData &data, const Triangle triangle,
 
 /**
  * Polygon job
- * @param data Data
- * @param polygon Polygon
+ * @param geometry Geometry
+ * @param polygon Polygon index
  * @param polygons Polygons
  * @param vertices Vertices
- * @param values Values
+ * @param ids Original indices
+ * @param cells Cells, with flat cell data only
  * @param indices Indices
  */
-void polygonJob(const VTUData &data, const Polygon &polygon,
-                std::vector<Polygon> &polygons, std::vector<Vertex> &vertices,
-                std::vector<double> &values,
-                std::vector<std::pair<uint, uint>> &indices) {
-  const std::vector<uint> polygonIndices = polygon.getIndices();
+void polygonJob(const VTUGeometry &geometry, const size_t polygon,
+                Polylines &polygons, std::vector<Vertex> &vertices,
+                std::vector<uint> &ids, std::vector<uint> &cells,
+                VertexMap &indices) {
+  const std::vector<uint> &offsets = geometry.polygons.getOffsets();
+  const std::vector<uint> &polygonIndices = geometry.polygons.getIndices();
+  const uint cell = geometry.polygonsCells.at(polygon);
 
-  Polygon newPolygon;
+  for (uint j = offsets[polygon]; j < offsets[polygon + 1]; ++j)
+    indexJob(polygonIndices[j], cell, geometry, vertices, ids, cells, indices,
+             [&polygons](uint newIndex) { polygons.addIndex(newIndex); });
 
-  std::for_each(polygonIndices.begin(), polygonIndices.end(),
-                [&data, &vertices, &values, &indices, &newPolygon](uint index) {
-                  indexJob(index, data, vertices, values, indices,
-                           [&newPolygon](uint newIndex) {
-                             newPolygon.addIndex(newIndex);
-                           });
-                });
+  polygons.endPolyline();
+}
 
-  polygons.push_back(newPolygon);
+/**
+ * Cell classes
+ * Cells with the same values in all flat arrays share a class
+ * @param flat Flat cell data
+ * @return Class of each cell, empty without flat cell data
+ */
+std::vector<uint> cellClasses(const std::vector<const VTUData *> &flat) {
+  std::vector<uint> classes;
+  if (flat.empty())
+    return classes;
+
+  const size_t numberOfCells = flat.front()->values.size / flat.front()->size;
+  classes.reserve(numberOfCells);
+
+  std::unordered_map<std::string, uint> keys;
+  std::string key;
+  for (size_t cell = 0; cell < numberOfCells; ++cell) {
+    key.clear();
+    for (const VTUData *data : flat)
+      for (int k = 0; k < data->size; ++k) {
+        const double value = data->values.at((size_t)data->size * cell + k);
+        key.append((const char *)&value, sizeof(double));
+      }
+
+    auto [entry, inserted] = keys.try_emplace(key, (uint)keys.size());
+    classes.push_back(entry->second);
+  }
+
+  return classes;
 }
 
 /**
- * Get result
- * @param data Data
- * @return Result
+ * Skin
+ * Boundary triangles of the tetrahedra, piece by piece if not welded
+ * @param geometry Geometry
+ * @param triangles Boundary triangles
+ * @param pieces First triangle of each piece, then the end, empty if welded
  */
-Result getResult(const VTUData &data) {
-  // Lines polygons, surface triangles & vertices
-  std::vector<Polygon> tempPloygons = data.polygons;
-  std::vector<Polygon> polygons;
-  std::vector<Triangle> tempTriangles = data.triangles;
-  std::vector<Triangle> triangles;
-  std::vector<Vertex> polygonsVertices;
-  std::vector<Vertex> trianglesVertices;
-  std::vector<double> polygonsValues;
-  std::vector<double> trianglesValues;
+void skin(const VTUGeometry &geometry, std::vector<Triangle> &triangles,
+          std::vector<size_t> &pieces) {
+  if (geometry.tetrahedraPieces.size() <= 2) {
+    triangles = Utils::skin(geometry.tetrahedra, geometry.vertices);
+    return;
+  }
+
+  for (size_t piece = 0; piece + 1 < geometry.tetrahedraPieces.size();
+       ++piece) {
+    std::vector<uint> ids(geometry.tetrahedraPieces.at(piece + 1) -
+                          geometry.tetrahedraPieces.at(piece));
+    std::iota(ids.begin(), ids.end(),
+              (uint)geometry.tetrahedraPieces.at(piece));
+
+    const std::vector<Triangle> pieceTriangles = Utils::skin(
+        geometry.tetrahedra, geometry.vertices, ids.cbegin(), ids.cend());
+
+    pieces.push_back(triangles.size());
+    triangles.insert(triangles.end(), pieceTriangles.begin(),
+                     pieceTriangles.end());
+  }
+  pieces.push_back(triangles.size());
+}
+
+/**
+ * Get result geometry
+ * Without triangles, the boundary of the tetrahedra is used. With flat cell
+ * data, vertices are split where the cell values differ
+ * @param geometry Geometry
+ * @param flat Flat cell data
+ * @return Result geometry
+ */
+std::shared_ptr<const ResultGeometry>
+getResultGeometry(const VTUGeometry &geometry,
+                  const std::vector<const VTUData *> &flat) {
+  auto result = std::make_shared<ResultGeometry>();
+  const std::vector<uint> classes = cellClasses(flat);
+
+  // Boundary of volume results
+  std::vector<Triangle> boundary;
+  std::vector<size_t> boundaryPieces;
+  const bool volume =
+      geometry.triangles.empty() && !geometry.tetrahedra.empty();
+  if (volume)
+    skin(geometry, boundary, boundaryPieces);
+
+  const std::vector<Triangle> &triangles =
+      volume ? boundary : geometry.triangles;
 
   // Polygons
-  std::vector<std::pair<uint, uint>> polygonsIndices;
-  std::for_each(tempPloygons.begin(), tempPloygons.end(),
-                [&data, &polygons, &polygonsVertices, &polygonsValues,
-                 &polygonsIndices](const Polygon &polygon) {
-                  polygonJob(data, polygon, polygons, polygonsVertices,
-                             polygonsValues, polygonsIndices);
-                });
+  VertexMap polygonsIndices((uint)geometry.vertices.size(), classes);
+  result->polygons.reserve(geometry.polygons.size(),
+                           geometry.polygons.getIndices().size());
+  for (size_t i = 0; i < geometry.polygons.size(); ++i)
+    polygonJob(geometry, i, result->polygons, result->polygonsVertices,
+               result->polygonsIds, result->polygonsCells, polygonsIndices);
 
   // Triangles
-  std::vector<std::pair<uint, uint>> trianglesIndices;
-  std::for_each(tempTriangles.begin(), tempTriangles.end(),
-                [&data, &triangles, &trianglesVertices, &trianglesValues,
+  VertexMap trianglesIndices((uint)geometry.vertices.size(), classes);
+  result->triangles.reserve(triangles.size());
+  std::for_each(triangles.begin(), triangles.end(),
+                [&geometry, &result,
                  &trianglesIndices](const Triangle &triangle) {
-                  triangleJob(data, triangle, triangles, trianglesVertices,
-                              trianglesValues, trianglesIndices);
+                  triangleJob(geometry, triangle, result->triangles,
+                              result->trianglesVertices, result->trianglesIds,
+                              result->trianglesCells, trianglesIndices);
                 });
 
   // min / max
-  std::vector<uint> polygonsMinMaxIndex = Utils::minMax(polygons);
-  std::vector<Vertex> polygonsMinMaxVertex = Utils::minMax(polygonsVertices);
-  std::vector<double> polygonsMinMaxValue = Utils::minMax(polygonsValues);
+  std::vector<uint> polygonsMinMaxIndex = Utils::minMax(result->polygons);
+  std::vector<Vertex> polygonsMinMaxVertex =
+      Utils::minMax(result->polygonsVertices);
+
+  std::vector<uint> trianglesMinMaxIndex = Utils::minMax(result->triangles);
+  std::vector<Vertex> trianglesMinMaxVertex =
+      Utils::minMax(result->trianglesVertices);
+
+  result->polygonsMinIndex = polygonsMinMaxIndex.at(0);
+  result->polygonsMaxIndex = polygonsMinMaxIndex.at(1);
+  result->polygonsMinVertex = polygonsMinMaxVertex.at(0);
+  result->polygonsMaxVertex = polygonsMinMaxVertex.at(1);
+
+  // Triangles are kept in order
+  result->trianglesPieces = volume ? boundaryPieces : geometry.trianglesPieces;
+
+  result->trianglesMinIndex = trianglesMinMaxIndex.at(0);
+  result->trianglesMaxIndex = trianglesMinMaxIndex.at(1);
+  result->trianglesMinVertex = trianglesMinMaxVertex.at(0);
+  result->trianglesMaxVertex = trianglesMinMaxVertex.at(1);
+
+  return result;
+}
 
-  std::vector<uint> trianglesMinMaxIndex = Utils::minMax(triangles);
-  std::vector<Vertex> trianglesMinMaxVertex = Utils::minMax(trianglesVertices);
-  std::vector<double> trianglesMinMaxValue = Utils::minMax(trianglesValues);
+/**
+ * Gather values
+ * @param values Values
+ * @param size Number of components
+ * @param ids Original indices
+ * @param gathered Values, in ids order
+ */
+template <typename T>
+void gatherValues(const T *values, const int size,
+                  const std::vector<uint> &ids, std::vector<float> &gathered) {
+  gathered.reserve(ids.size() * size);
+  std::for_each(ids.begin(), ids.end(),
+                [values, size, &gathered](const uint id) {
+                  for (int k = 0; k < size; ++k)
+                    gathered.push_back((float)values[(size_t)size * id + k]);
+                });
+}
 
-  // Result
+/**
+ * Gather values
+ * @param data Data
+ * @param ids Original indices
+ * @param cells Cells, for cell data
+ * @return Values, in ids order
+ */
+std::vector<float> gatherValues(const VTUData &data,
+                                const std::vector<uint> &ids,
+                                const std::vector<uint> &cells) {
+  std::vector<float> values;
+  if (data.size != 1 && data.size != 3)
+    return values;
+
+  if (data.cell) {
+    if (data.values.floats)
+      gatherValues(data.values.floats, data.size, cells, values);
+    else if (data.values.doubles)
+      gatherValues(data.values.doubles, data.size, cells, values);
+    return values;
+  }
+
+  if (data.values.floats)
+    gatherValues(data.values.floats, data.size, ids, values);
+  else if (data.values.doubles)
+    gatherValues(data.values.doubles, data.size, ids, values);
+
+  return values;
+}
+
+/**
+ * Get result
+ * @param data Data
+ * @param geometry Result geometry
+ * @return Result
+ */
+Result getResult(const VTUData &data,
+                 const std::shared_ptr<const ResultGeometry> &geometry) {
   Result result;
   result.size = data.size;
   result.name = data.name;
+  result.geometry = geometry;
+
+  result.polygonsValues =
+      gatherValues(data, geometry->polygonsIds, geometry->polygonsCells);
+  result.trianglesValues =
+      gatherValues(data, geometry->trianglesIds, geometry->trianglesCells);
+
+  // min / max
+  std::vector<double> polygonsMinMaxValue = Fields::range(
+      result.polygonsValues.data(), result.polygonsValues.size());
+  std::vector<double> trianglesMinMaxValue = Fields::range(
+      result.trianglesValues.data(), result.trianglesValues.size());
 
-  result.polygonsMinIndex = polygonsMinMaxIndex.at(0);
-  result.polygonsMaxIndex = polygonsMinMaxIndex.at(1);
-  result.polygonsMinVertex = polygonsMinMaxVertex.at(0);
-  result.polygonsMaxVertex = polygonsMinMaxVertex.at(1);
   result.polygonsMinValue = polygonsMinMaxValue.at(0);
   result.polygonsMaxValue = polygonsMinMaxValue.at(1);
-  result.polygons = polygons;
-  result.polygonsVertices = polygonsVertices;
-  result.polygonsValues = polygonsValues;
-
-  result.trianglesMinIndex = trianglesMinMaxIndex.at(0);
-  result.trianglesMaxIndex = trianglesMinMaxIndex.at(1);
-  result.trianglesMinVertex = trianglesMinMaxVertex.at(0);
-  result.trianglesMaxVertex = trianglesMinMaxVertex.at(1);
   result.trianglesMinValue = trianglesMinMaxValue.at(0);
   result.trianglesMaxValue = trianglesMinMaxValue.at(1);
-  result.triangles = triangles;
-  result.trianglesVertices = trianglesVertices;
-  result.trianglesValues = trianglesValues;
 
   return result;
 }
 
+/**
+ * Get result geometry
+ * @return Result geometry, null before read
+ */
+std::shared_ptr<const ResultGeometry> VTUReader::getResultGeometry() const {
+  if (!this->m_geometry)
+    return nullptr;
+
+  // Flat cell data
+  std::vector<const VTUData *> flat;
+  std::for_each(this->m_arrays.begin(), this->m_arrays.end(),
+                [&flat](const VTUData &data) {
+                  if (data.cell)
+                    flat.push_back(&data);
+                });
+
+  return ::getResultGeometry(*this->m_geometry, flat);
+}
+
 /**
  * Get results
+ * The result geometry is built once, and shared by all results
  * @return Results
  */
 std::vector<Result> VTUReader::getResults() const {
-  std::vector<VTUData> arrays = this->m_arrays;
-  std::vector<Result> results;
+  return this->getResults(this->getResultGeometry());
+}
 
-  std::for_each(arrays.begin(), arrays.end(), [&results](const VTUData &data) {
-    Result result = getResult(data);
+/**
+ * Get results
+ * @param geometry Result geometry, of this or a previous step with the same
+ * mesh and no flat cell data
+ * @return Results
+ */
+std::vector<Result> VTUReader::getResults(
+    const std::shared_ptr<const ResultGeometry> &geometry) const {
+  std::vector<Result> results;
+  if (!geometry)
+    return results;
 
-    results.push_back(result);
-  });
+  results.reserve(this->m_arrays.size());
+  std::for_each(this->m_arrays.begin(), this->m_arrays.end(),
+                [&geometry, &results](const VTUData &data) {
+                  results.push_back(getResult(data, geometry));
+                });
 
   return results;
 }
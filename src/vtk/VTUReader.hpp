@@ -1,74 +1,175 @@
 #ifndef _VTU_READER_
 #define _VTU_READER_
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
-#include <vtkSmartPointer.h>
-#include <vtkXMLUnstructuredGridReader.h>
-
-#include "../geometry/Polygon.hpp"
+#include "../geometry/Polylines.hpp"
 #include "../geometry/Tetrahedron.hpp"
 #include "../geometry/Triangle.hpp"
 #include "../geometry/Vertex.hpp"
 
-struct VTUData {
-  int size;
-  std::string name;
+// Cell data
+enum class CellDataMode {
+  // Not read
+  Ignore,
+  // Averaged at the points
+  Average,
+  // One value per face, vertices split where values differ
+  Flat
+};
+
+// Geometry, read once and shared by all arrays
+// Triangles & tetrahedra labels are their cell index, surface cells are
+// triangulated
+struct VTUGeometry {
   std::vector<Vertex> vertices;
-  std::vector<Polygon> polygons;
+  Polylines polygons;
   std::vector<Triangle> triangles;
   std::vector<Tetrahedron> tetrahedra;
-  std::vector<double> values;
+  // Number of cells, triangulated & skipped cells included
+  size_t numberOfCells = 0;
+  // Cell index of each polygon
+  std::vector<uint> polygonsCells;
+  // First triangle of each piece, then the end, empty if welded
+  std::vector<size_t> trianglesPieces;
+  // First tetrahedron of each piece, then the end, empty if welded
+  std::vector<size_t> tetrahedraPieces;
+  // Merged index of each piece vertex, empty with one piece
+  std::vector<std::vector<uint>> remaps;
+  // Fingerprints of the points & cells of each piece, to check the next steps
+  std::vector<uint64_t> pointsFingerprints;
+  std::vector<uint64_t> cellsFingerprints;
 };
 
-struct Result {
-  uint size;
+// Values, a view over float or double storage
+struct VTUValues {
+  // Storage, kept alive by the view
+  std::shared_ptr<const void> storage;
+  // Float storage, or nullptr
+  const float *floats = nullptr;
+  // Double storage, or nullptr
+  const double *doubles = nullptr;
+  // Number of values
+  size_t size = 0;
+
+  // Value
+  double at(const size_t index) const {
+    return this->floats ? this->floats[index] : this->doubles[index];
+  }
+};
+
+struct VTUData {
+  int size;
   std::string name;
+  // One value per cell, not per point
+  bool cell = false;
+  std::shared_ptr<const VTUGeometry> geometry;
+  VTUValues values;
+};
 
+// Result geometry, compacted once and shared by all results
+struct ResultGeometry {
   uint polygonsMinIndex;
   uint polygonsMaxIndex;
   Vertex polygonsMinVertex;
   Vertex polygonsMaxVertex;
-  double polygonsMinValue;
-  double polygonsMaxValue;
-  std::vector<Polygon> polygons;
+  Polylines polygons;
   std::vector<Vertex> polygonsVertices;
-  std::vector<double> polygonsValues;
+  // Original index of each polygons vertex
+  std::vector<uint> polygonsIds;
+  // Cell of each polygons vertex, with flat cell data only
+  std::vector<uint> polygonsCells;
 
   uint trianglesMinIndex;
   uint trianglesMaxIndex;
   Vertex trianglesMinVertex;
   Vertex trianglesMaxVertex;
-  double trianglesMinValue;
-  double trianglesMaxValue;
   std::vector<Triangle> triangles;
   std::vector<Vertex> trianglesVertices;
-  std::vector<double> trianglesValues;
+  // Original index of each triangles vertex
+  std::vector<uint> trianglesIds;
+  // Cell of each triangles vertex, with flat cell data only
+  std::vector<uint> trianglesCells;
+  // First triangle of each piece, then the end, empty if welded
+  std::vector<size_t> trianglesPieces;
 };
 
+struct Result {
+  uint size;
+  std::string name;
+  std::shared_ptr<const ResultGeometry> geometry;
+
+  double polygonsMinValue;
+  double polygonsMaxValue;
+  std::vector<float> polygonsValues;
+
+  double trianglesMinValue;
+  double trianglesMaxValue;
+  std::vector<float> trianglesValues;
+};
+
+// Piece, while reading
+struct VTUPiece;
+
 class VTUReader {
 private:
   std::string m_fileName = "";
-  vtkSmartPointer<vtkXMLUnstructuredGridReader> m_reader =
-      vtkSmartPointer<vtkXMLUnstructuredGridReader>::New();
+  // Weld the interface vertices of pieces
+  bool m_weld = true;
+  // Cell data
+  CellDataMode m_cellData = CellDataMode::Ignore;
+  // Parse .vtu files without VTK when possible
+  bool m_native = false;
 
+  std::shared_ptr<const VTUGeometry> m_geometry = nullptr;
   std::vector<VTUData> m_arrays = std::vector<VTUData>();
 
+  // Read pieces, .vtu or .pvtu reader
+  template <typename ReaderT> bool readPieces();
+
+  // Read native, without VTK
+  bool readNative();
+
+  // Merge pieces
+  bool mergePieces(std::vector<VTUPiece> &);
+
 public:
   // Constructor
   VTUReader();
   // Constructor
   explicit VTUReader(const std::string &);
 
+  // Set weld
+  void setWeld(const bool);
+
+  // Set cell data
+  void setCellData(const CellDataMode);
+
+  // Set native
+  void setNative(const bool);
+
+  // Set geometry, reused from a previous step
+  void setGeometry(const std::shared_ptr<const VTUGeometry> &);
+
   // Read
   bool read();
 
+  // Get geometry
+  std::shared_ptr<const VTUGeometry> getGeometry() const;
+
   // Get arrays
-  std::vector<VTUData> getArrays() const;
+  const std::vector<VTUData> &getArrays() const;
+
+  // Get result geometry
+  std::shared_ptr<const ResultGeometry> getResultGeometry() const;
 
   // Get results
   std::vector<Result> getResults() const;
+  std::vector<Result>
+  getResults(const std::shared_ptr<const ResultGeometry> &) const;
 };
 
 #endif // VTU_READER_
@@ -0,0 +1,46 @@
+#include <catch2/catch.hpp>
+
+#include "../../src/geometry/Polylines.hpp"
+
+TEST_CASE("Polylines") {
+  SECTION("Constructor") {
+    auto polylines = Polylines();
+    CHECK(polylines.size() == 0);
+    CHECK(polylines.getOffsets() == std::vector<uint>({0}));
+    CHECK(polylines.getSegments().empty());
+  }
+
+  SECTION("addIndex") {
+    auto polylines = Polylines();
+    polylines.reserve(3, 6);
+    for (const uint index : {0, 1, 2})
+      polylines.addIndex(index);
+    polylines.endPolyline();
+    polylines.addIndex(3);
+    polylines.endPolyline();
+    for (const uint index : {4, 5})
+      polylines.addIndex(index);
+    polylines.endPolyline();
+
+    CHECK(polylines.size() == 3);
+    CHECK(polylines.getOffsets() == std::vector<uint>({0, 3, 4, 6}));
+    CHECK(polylines.getIndices() == std::vector<uint>({0, 1, 2, 3, 4, 5}));
+
+    // Not joined, one point polyline skipped
+    CHECK(polylines.getSegments() == std::vector<uint>({0, 1, 1, 2, 4, 5}));
+    CHECK(polylines.getPoints() == std::vector<uint>({3}));
+  }
+
+  SECTION("vertices") {
+    auto polylines = Polylines();
+    for (const uint index : {0, 1, 2}) {
+      polylines.addIndex(index);
+      polylines.endPolyline();
+    }
+
+    CHECK(polylines.size() == 3);
+    CHECK(polylines.getIndices() == std::vector<uint>({0, 1, 2}));
+    CHECK(polylines.getSegments().empty());
+    CHECK(polylines.getPoints() == std::vector<uint>({0, 1, 2}));
+  }
+}
@@ -61,4 +61,249 @@ TEST_CASE("Gmsh") {
     bool res = mesh.load("../test/assets/Point.msh");
     CHECK(res);
   }
+
+  SECTION("load - sparse tags") {
+    auto dense = Gmsh();
+    dense.load("../test/assets/Square.msh");
+
+    auto mesh = Gmsh();
+    bool res = mesh.load("../test/assets/Square.sparse.msh");
+    CHECK(res);
+
+    Surface surface = mesh.getSurface(1);
+    Surface expected = dense.getSurface(1);
+    CHECK(surface.triangles.size() == expected.triangles.size());
+    CHECK(surface.vertices.size() == expected.vertices.size());
+    for (size_t i = 0; i < surface.vertices.size(); ++i) {
+      CHECK(surface.vertices.at(i).X() == expected.vertices.at(i).X());
+      CHECK(surface.vertices.at(i).Y() == expected.vertices.at(i).Y());
+    }
+  }
+
+  SECTION("load - second order") {
+    auto linear = Gmsh();
+    linear.load("../test/assets/Square.msh");
+
+    // 6-nodes triangles, 3-nodes lines, and unsupported quadrangles
+    auto mesh = Gmsh();
+    bool res = mesh.load("../test/assets/Square.order2.msh");
+    CHECK(res);
+    CHECK(mesh.getSurfaceLabels() == linear.getSurfaceLabels());
+
+    Surface surface = mesh.getSurface(1);
+    Surface expected = linear.getSurface(1);
+    CHECK(surface.triangles.size() == expected.triangles.size());
+    CHECK(surface.vertices.size() == expected.vertices.size());
+    for (size_t i = 0; i < surface.vertices.size(); ++i) {
+      CHECK(surface.vertices.at(i).X() == expected.vertices.at(i).X());
+      CHECK(surface.vertices.at(i).Y() == expected.vertices.at(i).Y());
+    }
+  }
+
+  SECTION("load - MSH 2.2 binary") {
+    auto ascii = Gmsh();
+    ascii.load("../test/assets/Square.msh");
+
+    auto mesh = Gmsh();
+    bool res = mesh.load("../test/assets/Square.binary.msh");
+    CHECK(res);
+
+    std::vector<uint> labels = mesh.getSurfaceLabels();
+    CHECK(labels == ascii.getSurfaceLabels());
+
+    Surface surface = mesh.getSurface(labels.at(0));
+    Surface expected = ascii.getSurface(labels.at(0));
+    CHECK(surface.triangles.size() == expected.triangles.size());
+    CHECK(surface.vertices.size() == expected.vertices.size());
+    CHECK(surface.maxIndex == expected.maxIndex);
+    for (size_t i = 0; i < surface.vertices.size(); ++i)
+      CHECK(surface.vertices.at(i).X() == expected.vertices.at(i).X());
+  }
+
+  SECTION("load - MSH 4.1") {
+    auto mesh = Gmsh();
+
+    bool res = mesh.load("../test/assets/Cube.wrong.msh");
+    CHECK(res);
+
+    std::vector<uint> labels = mesh.getSurfaceLabels();
+    CHECK(labels == std::vector<uint>({1, 2, 3, 4, 5, 6}));
+    for (const uint label : labels) {
+      Surface surface = mesh.getSurface(label);
+      CHECK(surface.triangles.size() == 4);
+      CHECK(surface.vertices.size() == 5);
+    }
+  }
+
+  SECTION("load - MSH 4.1 binary") {
+    auto ascii = Gmsh();
+    ascii.load("../test/assets/Cube.wrong.msh");
+
+    auto mesh = Gmsh();
+    bool res = mesh.load("../test/assets/Cube.binary.msh");
+    CHECK(res);
+
+    std::vector<uint> labels = mesh.getSurfaceLabels();
+    CHECK(labels == ascii.getSurfaceLabels());
+    for (const uint label : labels) {
+      Surface surface = mesh.getSurface(label);
+      Surface expected = ascii.getSurface(label);
+      CHECK(surface.triangles.size() == expected.triangles.size());
+      CHECK(surface.vertices.size() == expected.vertices.size());
+      for (size_t i = 0; i < surface.vertices.size(); ++i)
+        CHECK(surface.vertices.at(i).X() == expected.vertices.at(i).X());
+    }
+  }
+
+  SECTION("load - physical groups") {
+    auto mesh = Gmsh();
+
+    bool res = mesh.load("../test/assets/Cube.msh", {"1", "3"});
+    CHECK(res);
+    CHECK(mesh.getSurfaceLabels() == std::vector<uint>({1, 3}));
+    CHECK(mesh.getVolumeLabels() == std::vector<uint>({1}));
+
+    auto full = Gmsh();
+    full.load("../test/assets/Cube.msh");
+    CHECK(mesh.getSurface(3).triangles.size() ==
+          full.getSurface(3).triangles.size());
+
+    auto named = Gmsh();
+    res = named.load("../test/assets/Cube.groups.msh", {"top", "left side"});
+    CHECK(res);
+    CHECK(named.getSurfaceLabels() == std::vector<uint>({2, 6}));
+    CHECK(named.getVolumeLabels().empty());
+    CHECK(named.getSurface(2).vertices.size() == 5);
+
+    auto unknown = Gmsh();
+    res = unknown.load("../test/assets/Cube.groups.msh", {"unknown"});
+    CHECK(!res);
+  }
+
+  SECTION("getSurface") {
+    auto mesh = Gmsh();
+    mesh.load("../test/assets/Square.msh");
+
+    std::vector<uint> labels = mesh.getSurfaceLabels();
+    CHECK(labels.size() == 1);
+
+    IndexMap indices;
+    Surface surface = mesh.getSurface(labels.at(0), indices);
+    CHECK(surface.triangles.size() == 4);
+    CHECK(surface.vertices.size() == 5);
+    CHECK(surface.maxIndex == 4);
+
+    Surface none = mesh.getSurface(1000, indices);
+    CHECK(none.triangles.size() == 0);
+    CHECK(none.vertices.size() == 0);
+  }
+
+  SECTION("partitionTriangles") {
+    auto mesh = Gmsh();
+    mesh.load("../test/assets/Cube.msh");
+
+    Partition partition = mesh.partitionTriangles();
+    CHECK(partition.labels == mesh.getSurfaceLabels());
+    CHECK(partition.offsets.size() == partition.labels.size() + 1);
+    CHECK(partition.offsets.front() == 0);
+    CHECK(partition.offsets.back() == partition.elements.size());
+  }
+
+  SECTION("getSurfaces") {
+    auto mesh = Gmsh();
+    mesh.load("../test/assets/Cube.msh");
+
+    std::vector<uint> labels = mesh.getSurfaceLabels();
+    std::vector<Surface> surfaces = mesh.getSurfaces();
+    CHECK(surfaces.size() == labels.size());
+
+    for (size_t i = 0; i < surfaces.size(); ++i) {
+      Surface surface = mesh.getSurface(labels.at(i));
+      CHECK(surfaces.at(i).label == labels.at(i));
+      CHECK(surfaces.at(i).triangles.size() == surface.triangles.size());
+      CHECK(surfaces.at(i).vertices.size() == surface.vertices.size());
+    }
+  }
+
+  SECTION("getVolume") {
+    auto mesh = Gmsh();
+    mesh.load("../test/assets/Cube.msh");
+
+    std::vector<uint> labels = mesh.getVolumeLabels();
+    CHECK(labels.size() == 1);
+
+    Volume volume = mesh.getVolume(labels.at(0));
+    CHECK(volume.label == labels.at(0));
+    CHECK(volume.tetrahedra.size() == 36644);
+    CHECK(volume.vertices.size() == 7348);
+    CHECK(volume.maxIndex == 7347);
+
+    Partition partition = mesh.partitionTetrahedra();
+    IndexMap indices;
+    Volume same = mesh.getVolume(partition, 0, indices);
+    CHECK(same.tetrahedra.size() == volume.tetrahedra.size());
+  }
+
+  SECTION("getSkin") {
+    auto mesh = Gmsh();
+    mesh.load("../test/assets/Cube.msh");
+
+    // The skin of the cube is made of all its boundary triangles
+    Surface skin = mesh.getSkin(mesh.getVolumeLabels().at(0));
+    std::vector<Surface> surfaces = mesh.getSurfaces();
+    size_t numberOfTriangles = 0;
+    for (const Surface &surface : surfaces)
+      numberOfTriangles += surface.triangles.size();
+    CHECK(skin.triangles.size() == numberOfTriangles);
+    CHECK(skin.minVertex.X() == 0.);
+    CHECK(skin.maxVertex.X() == 1.);
+
+    // Outward orientation, the enclosed volume is positive
+    double enclosed = 0;
+    for (const Triangle &triangle : skin.triangles) {
+      const Vertex &a = skin.vertices.at(triangle.I1());
+      const Vertex &b = skin.vertices.at(triangle.I2());
+      const Vertex &c = skin.vertices.at(triangle.I3());
+      enclosed += (a.X() * (b.Y() * c.Z() - b.Z() * c.Y()) -
+                   a.Y() * (b.X() * c.Z() - b.Z() * c.X()) +
+                   a.Z() * (b.X() * c.Y() - b.Y() * c.X())) /
+                  6.;
+    }
+    CHECK(enclosed == Approx(1.));
+
+    Partition partition = mesh.partitionTetrahedra();
+    IndexMap indices;
+    Surface same = mesh.getSkin(partition, 0, indices);
+    CHECK(same.triangles.size() == skin.triangles.size());
+  }
+
+  SECTION("getSurface / getSkin - shared vertices") {
+    auto mesh = Gmsh();
+    mesh.load("../test/assets/Cube.msh");
+
+    Partition partition = mesh.partitionTriangles();
+    Partition volumesPartition = mesh.partitionTetrahedra();
+    IndexMap indices;
+    std::vector<Vertex> vertices;
+
+    size_t numberOfVertices = 0;
+    std::vector<Surface> surfaces;
+    for (uint bucket = 0; bucket < partition.labels.size(); ++bucket) {
+      surfaces.push_back(
+          mesh.getSurface(partition, bucket, indices, vertices));
+      CHECK(surfaces.back().vertices.empty());
+      CHECK(surfaces.back().maxIndex < vertices.size());
+      numberOfVertices +=
+          mesh.getSurface(partition.labels.at(bucket)).vertices.size();
+    }
+
+    // Edges are shared between faces
+    CHECK(vertices.size() < numberOfVertices);
+
+    // The skin only uses boundary vertices, already there
+    const size_t boundary = vertices.size();
+    Surface skin = mesh.getSkin(volumesPartition, 0, indices, vertices);
+    CHECK(vertices.size() == boundary);
+    CHECK(skin.maxIndex < vertices.size());
+  }
 }
@@ -0,0 +1,76 @@
+#include <catch2/catch.hpp>
+
+#include "../../src/utils/IndexMap.hpp"
+
+TEST_CASE("IndexMap") {
+  SECTION("Constructor 1") {
+    auto indices = IndexMap();
+    CHECK(indices.size() == 0);
+  }
+
+  SECTION("Constructor 2") {
+    auto indices = IndexMap(10);
+    CHECK(indices.size() == 0);
+  }
+
+  SECTION("insert / find - dense") {
+    auto indices = IndexMap(10);
+    bool inserted;
+
+    CHECK(indices.find(5) == -1);
+
+    CHECK(indices.insert(5, inserted) == 0);
+    CHECK(inserted);
+    CHECK(indices.insert(2, inserted) == 1);
+    CHECK(inserted);
+    CHECK(indices.insert(5, inserted) == 0);
+    CHECK(!inserted);
+
+    CHECK(indices.find(5) == 0);
+    CHECK(indices.find(2) == 1);
+    CHECK(indices.size() == 2);
+  }
+
+  SECTION("insert / find - sparse") {
+    auto indices = IndexMap(10);
+    bool inserted;
+
+    CHECK(indices.insert(1000, inserted) == 0);
+    CHECK(inserted);
+    CHECK(indices.insert(3, inserted) == 1);
+    CHECK(indices.insert(1000, inserted) == 0);
+    CHECK(!inserted);
+
+    CHECK(indices.find(1000) == 0);
+    CHECK(indices.find(2000) == -1);
+  }
+
+  SECTION("reserve") {
+    auto indices = IndexMap();
+    bool inserted;
+
+    indices.insert(7, inserted);
+    indices.reserve(10);
+    CHECK(indices.find(7) == 0);
+
+    indices.insert(8, inserted);
+    CHECK(inserted);
+    CHECK(indices.find(8) == 1);
+  }
+
+  SECTION("clear") {
+    auto indices = IndexMap(10);
+    bool inserted;
+
+    indices.insert(1, inserted);
+    indices.insert(100, inserted);
+    indices.clear();
+
+    CHECK(indices.size() == 0);
+    CHECK(indices.find(1) == -1);
+    CHECK(indices.find(100) == -1);
+
+    CHECK(indices.insert(1, inserted) == 0);
+    CHECK(inserted);
+  }
+}
@@ -0,0 +1,31 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "../../src/utils/MappedFile.hpp"
+
+TEST_CASE("MappedFile") {
+  SECTION("Constructor") {
+    auto file = MappedFile();
+    CHECK(file.data() == nullptr);
+    CHECK(file.size() == 0);
+  }
+
+  SECTION("open - no file") {
+    auto file = MappedFile();
+    CHECK(!file.open(""));
+    CHECK(!file.open("../test/assets/not_existing.msh"));
+  }
+
+  SECTION("open - directory") {
+    auto file = MappedFile();
+    CHECK(!file.open("../test/assets"));
+  }
+
+  SECTION("open") {
+    auto file = MappedFile();
+    CHECK(file.open("../test/assets/Point.msh"));
+    CHECK(file.size());
+    CHECK(std::string(file.data(), 11) == "$MeshFormat");
+  }
+}
@@ -0,0 +1,85 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "../../src/utils/Scanner.hpp"
+
+TEST_CASE("Scanner") {
+  SECTION("Constructor") {
+    auto scanner = Scanner();
+    CHECK(scanner.eof());
+  }
+
+  SECTION("token") {
+    const std::string text = " $Nodes\n 12\r\n";
+    auto scanner = Scanner(text.data(), text.data() + text.size());
+
+    CHECK(scanner.token() == "$Nodes");
+    CHECK(scanner.token() == "12");
+    CHECK(scanner.token().empty());
+    CHECK(scanner.eof());
+  }
+
+  SECTION("skipTo") {
+    const std::string text = "$MeshFormat 2.2 0 8 $Nodes 3";
+    auto scanner = Scanner(text.data(), text.data() + text.size());
+
+    CHECK(scanner.skipTo("$Nodes"));
+    CHECK(scanner.token() == "3");
+    CHECK(!scanner.skipTo("$Elements"));
+  }
+
+  SECTION("skipLine") {
+    const std::string text = "1 2 3\n4";
+    auto scanner = Scanner(text.data(), text.data() + text.size());
+
+    scanner.skipLine();
+    CHECK(scanner.token() == "4");
+    scanner.skipLine();
+    CHECK(scanner.eof());
+  }
+
+  SECTION("read") {
+    const std::string text = "7 -2 0.5 -1e-3 +2.5 abc";
+    auto scanner = Scanner(text.data(), text.data() + text.size());
+
+    uint u;
+    int i;
+    double d;
+    CHECK(scanner.read(u));
+    CHECK(u == 7);
+    CHECK(!scanner.read(u));
+    CHECK(scanner.read(i));
+    CHECK(i == -2);
+    CHECK(scanner.read(d));
+    CHECK(d == 0.5);
+    CHECK(scanner.read(d));
+    CHECK(d == -1e-3);
+    CHECK(scanner.read(d));
+    CHECK(d == 2.5);
+    CHECK(!scanner.read(d));
+    CHECK(scanner.token() == "abc");
+  }
+
+  SECTION("readBytes") {
+    const std::string text("$Nodes\n\x01\x00\x00\x00", 11);
+    auto scanner = Scanner(text.data(), text.data() + text.size());
+
+    CHECK(scanner.token() == "$Nodes");
+    scanner.skipLine();
+
+    int value = 0;
+    CHECK(scanner.readBytes(&value, sizeof(int)));
+    CHECK(value == 1);
+    CHECK(!scanner.readBytes(&value, sizeof(int)));
+  }
+
+  SECTION("skipBytes") {
+    const std::string text("\x01\x00\x00\x00 end", 8);
+    auto scanner = Scanner(text.data(), text.data() + text.size());
+
+    CHECK(scanner.skipBytes(sizeof(int)));
+    CHECK(scanner.token() == "end");
+    CHECK(!scanner.skipBytes(1));
+  }
+}
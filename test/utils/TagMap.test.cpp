@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+
+#include "../../src/utils/TagMap.hpp"
+
+TEST_CASE("TagMap") {
+  SECTION("Constructor") {
+    auto tags = TagMap();
+    CHECK(tags.size() == 0);
+    CHECK(tags.find(1) == -1);
+  }
+
+  SECTION("build - dense") {
+    auto tags = TagMap();
+    CHECK(tags.build({5, 6, 7, 8}));
+    CHECK(tags.dense());
+    CHECK(tags.size() == 4);
+
+    CHECK(tags.find(5) == 0);
+    CHECK(tags.find(8) == 3);
+    CHECK(tags.find(4) == -1);
+    CHECK(tags.find(9) == -1);
+  }
+
+  SECTION("build - sparse") {
+    auto tags = TagMap();
+    CHECK(tags.build({40, 10, 1000000000000, 20}));
+    CHECK(!tags.dense());
+    CHECK(tags.size() == 4);
+
+    CHECK(tags.find(40) == 0);
+    CHECK(tags.find(10) == 1);
+    CHECK(tags.find(1000000000000) == 2);
+    CHECK(tags.find(20) == 3);
+    CHECK(tags.find(30) == -1);
+    CHECK(tags.find(0) == -1);
+  }
+
+  SECTION("build - wrong tags") {
+    auto tags = TagMap();
+    CHECK(!tags.build({0, 1, 2}));
+    CHECK(!tags.build({3, 1, 3}));
+  }
+}
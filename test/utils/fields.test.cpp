@@ -0,0 +1,91 @@
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+#include "../../src/utils/fields.hpp"
+
+TEST_CASE("fields") {
+  // 11 tuples, not a multiple of the lanes
+  std::vector<double> vectors;
+  for (int i = 0; i < 11; ++i) {
+    vectors.push_back(i - 5.);
+    vectors.push_back(2. * i);
+    vectors.push_back(-3.);
+  }
+
+  SECTION("range") {
+    std::vector<float> values = {3.f, -1.f, 2.f, 7.f, 0.f, 1.f, 1.f,
+                                 1.f, 1.f,  -4.f, 5.f};
+    auto mm = Fields::range(values.data(), values.size());
+    CHECK(mm.at(0) == -4.);
+    CHECK(mm.at(1) == 7.);
+
+    auto empty = Fields::range(values.data(), 0);
+    CHECK(empty.at(0) == 0.);
+    CHECK(empty.at(1) == 0.);
+  }
+
+  SECTION("range - component") {
+    auto mm = Fields::range(vectors.data(), 11, 3, 1);
+    CHECK(mm.at(0) == 0.);
+    CHECK(mm.at(1) == 20.);
+  }
+
+  SECTION("magnitude") {
+    std::vector<float> magnitudes;
+    auto mm = Fields::magnitude(vectors.data(), 11, magnitudes);
+    REQUIRE(magnitudes.size() == 11);
+
+    double min = 1e9;
+    double max = 0;
+    for (int i = 0; i < 11; ++i) {
+      const double x = vectors[3 * i + 0];
+      const double y = vectors[3 * i + 1];
+      const double z = vectors[3 * i + 2];
+      const auto expected = (float)std::sqrt(x * x + y * y + z * z);
+      CHECK(magnitudes[i] == expected);
+      min = std::min(min, (double)expected);
+      max = std::max(max, (double)expected);
+    }
+    CHECK(mm.at(0) == min);
+    CHECK(mm.at(1) == max);
+  }
+
+  SECTION("component") {
+    std::vector<float> components;
+    auto mm = Fields::component(vectors.data(), 11, 3, 0, components);
+    REQUIRE(components.size() == 11);
+    CHECK(components.front() == -5.f);
+    CHECK(components.back() == 5.f);
+    CHECK(mm.at(0) == -5.);
+    CHECK(mm.at(1) == 5.);
+  }
+
+  SECTION("quantize") {
+    std::vector<unsigned char> buffer;
+    std::vector<float> values = {-1.f, 0.f, 1.f, 3.f, std::nanf("")};
+    CHECK(Fields::quantize(values.data(), values.size(), 1, {-1.}, {1.},
+                           buffer) == 4);
+    REQUIRE(buffer.size() == 5 * 4);
+
+    const auto at = [&buffer](const size_t offset) {
+      return (unsigned)(buffer[offset] | buffer[offset + 1] << 8);
+    };
+    CHECK(at(0) == 0);
+    CHECK(at(4) == 32768);
+    CHECK(at(8) == 65535);
+    CHECK(at(12) == 65535); // Clamped
+    CHECK(at(16) == 0);     // NaN
+    CHECK(at(2) == 0);      // Padding
+
+    buffer.clear();
+    CHECK(Fields::quantize(vectors.data(), 11, 3, {-5., 0., -3.},
+                           {5., 20., -3.}, buffer) == 8);
+    REQUIRE(buffer.size() == 11 * 8);
+    CHECK(at(0) == 0);
+    CHECK(at(2) == 0);
+    CHECK(at(4) == 0); // Constant component
+    CHECK(at(10 * 8) == 65535);
+    CHECK(at(10 * 8 + 2) == 65535);
+  }
+}
@@ -1,5 +1,10 @@
 #include <catch2/catch.hpp>
 
+#include <chrono>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
 #include "../../src/utils/utils.hpp"
 
 TEST_CASE("Utils") {
@@ -20,21 +25,18 @@ TEST_CASE("Utils") {
     CHECK(buffer.size());
   }
 
-  SECTION("floatToBuffer") {
+  SECTION("ushortToBuffer") {
     auto buffer = std::vector<unsigned char>();
-    Utils::floatToBuffer(1., buffer);
+    Utils::ushortToBuffer(1, buffer);
 
-    CHECK(buffer.size());
+    CHECK(buffer.size() == 2);
   }
 
-  SECTION("findIndex") {
-    auto indices = std::vector<std::pair<uint, uint>>();
-    int index = Utils::findIndex(1, indices);
-    CHECK(index == -1);
+  SECTION("floatToBuffer") {
+    auto buffer = std::vector<unsigned char>();
+    Utils::floatToBuffer(1., buffer);
 
-    indices.push_back({1, 2});
-    index = Utils::findIndex(1, indices);
-    CHECK(index == 2);
+    CHECK(buffer.size());
   }
 
   SECTION("minMax - tetrahedron") {
@@ -57,15 +59,15 @@ TEST_CASE("Utils") {
     CHECK(mm.at(1) == 0);
   }
 
-  SECTION("minMax - polygon") {
-    auto polygons = std::vector<Polygon>();
-    Polygon polygon;
-    polygon.addIndex(1);
-    polygons.push_back(polygon);
+  SECTION("minMax - polylines") {
+    auto polylines = Polylines();
+    polylines.addIndex(2);
+    polylines.addIndex(1);
+    polylines.endPolyline();
 
-    auto mm = Utils::minMax(polygons);
+    auto mm = Utils::minMax(polylines);
     CHECK(mm.at(0) == 0);
-    CHECK(mm.at(1) == 1);
+    CHECK(mm.at(1) == 2);
   }
 
   SECTION("minMax - vertex") {
@@ -87,4 +89,102 @@ TEST_CASE("Utils") {
     CHECK(mm.at(0) == 0.);
     CHECK(mm.at(1) == 1.);
   }
-}
\ No newline at end of file
+
+  SECTION("minMax - float values") {
+    auto values = std::vector<float>();
+    values.push_back(1.5f);
+    values.push_back(-2.f);
+
+    auto mm = Utils::minMax(values);
+    CHECK(mm.at(0) == -2.);
+    CHECK(mm.at(1) == 1.5);
+  }
+
+  SECTION("numberOfThreads") { CHECK(Utils::numberOfThreads() >= 1); }
+
+  SECTION("parallelFor") {
+    std::vector<int> values(1000, 0);
+    std::vector<int> expected(1000, 0);
+    for (size_t i = 0; i < expected.size(); ++i)
+      expected[i] = (int)i;
+
+    Utils::parallelFor(values.size(),
+                       [&values](const size_t i) { values[i] = (int)i; });
+    CHECK(values == expected);
+
+    CHECK_THROWS(Utils::parallelFor(10, [](const size_t i) {
+      if (i == 5)
+        throw std::runtime_error("error");
+    }));
+  }
+
+  SECTION("parallelFor - memory bounded") {
+    // Costs 1, 2 & 3, budget 4, 5 is over budget
+    const std::vector<size_t> costs = {1, 2, 3, 1, 5, 2, 3, 1, 1, 2};
+    std::vector<size_t> started;
+    size_t used = 0;
+    size_t peak = 0;
+    bool alone = true;
+    std::mutex mutex;
+
+    Utils::parallelFor(
+        costs.size(), 4, 4, [&costs](const size_t i) { return costs[i]; },
+        [&](const size_t i) {
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            started.push_back(i);
+            used += costs[i];
+            if (costs[i] > 4)
+              alone = alone && used == costs[i];
+            else
+              peak = std::max(peak, used);
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            used -= costs[i];
+          }
+        });
+
+    std::vector<size_t> expected(costs.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK(started == expected);
+    CHECK(peak <= 4);
+    CHECK(alone);
+
+    CHECK_THROWS(Utils::parallelFor(
+        10, 2, 4, [](const size_t) { return 1; },
+        [](const size_t i) {
+          if (i == 5)
+            throw std::runtime_error("error");
+        }));
+  }
+
+  SECTION("skin") {
+    auto vertices = std::vector<Vertex>();
+    vertices.push_back(Vertex(0, 0, 0));
+    vertices.push_back(Vertex(1, 0, 0));
+    vertices.push_back(Vertex(0, 1, 0));
+    vertices.push_back(Vertex(0, 0, 1));
+    vertices.push_back(Vertex(1, 1, 1));
+
+    // Single tetrahedron, negatively oriented
+    auto tetrahedra = std::vector<Tetrahedron>();
+    tetrahedra.push_back(Tetrahedron(0, 2, 1, 3, 1));
+
+    auto triangles = Utils::skin(tetrahedra, vertices);
+    CHECK(triangles.size() == 4);
+    CHECK(triangles.at(0).Label() == 1);
+    // Bottom face, outward is -z
+    CHECK(triangles.at(0).getIndices() == std::vector<uint>({0, 2, 1}));
+
+    // Two tetrahedra sharing the (1, 2, 3) face
+    tetrahedra.push_back(Tetrahedron(1, 2, 3, 4, 1));
+    triangles = Utils::skin(tetrahedra, vertices);
+    CHECK(triangles.size() == 6);
+
+    auto ids = std::vector<uint>({1});
+    triangles = Utils::skin(tetrahedra, vertices, ids.cbegin(), ids.cend());
+    CHECK(triangles.size() == 4);
+  }
+}
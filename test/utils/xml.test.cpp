@@ -0,0 +1,45 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+
+#include "../../src/utils/xml.hpp"
+
+TEST_CASE("XML") {
+  SECTION("nextTag") {
+    const std::string text = "<?xml version=\"1.0\"?><!-- <Skipped> -->"
+                             "<VTKFile type=\"Collection\">"
+                             "<DataSet file=\"a.vtu\"/></VTKFile>";
+    size_t position = 0;
+    XML::Tag tag;
+
+    CHECK(XML::nextTag(text, position, tag));
+    CHECK(tag.name == "VTKFile");
+    CHECK(!tag.closing);
+    CHECK(!tag.empty);
+
+    CHECK(XML::nextTag(text, position, tag));
+    CHECK(tag.name == "DataSet");
+    CHECK(tag.empty);
+    CHECK(tag.text == "<DataSet file=\"a.vtu\"/>");
+
+    CHECK(XML::nextTag(text, position, tag));
+    CHECK(tag.name == "VTKFile");
+    CHECK(tag.closing);
+
+    CHECK(!XML::nextTag(text, position, tag));
+  }
+
+  SECTION("attribute") {
+    const std::string tag =
+        "<DataArray type='Float64' Name=\"offset\" offset=\"12\"/>";
+    std::string_view value;
+
+    CHECK(XML::attribute(tag, "type", value));
+    CHECK(value == "Float64");
+    CHECK(XML::attribute(tag, "offset", value));
+    CHECK(value == "12");
+    CHECK(XML::attribute(tag, "Name", value));
+    CHECK(value == "offset");
+    CHECK(!XML::attribute(tag, "format", value));
+  }
+}
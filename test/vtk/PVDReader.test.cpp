@@ -0,0 +1,32 @@
+#include <catch2/catch.hpp>
+
+#include "../../src/vtk/PVDReader.hpp"
+
+TEST_CASE("PVDReader") {
+  SECTION("Constructor 1") { auto reader = PVDReader(); }
+
+  SECTION("Constructor 2") { auto reader = PVDReader("filename"); }
+
+  SECTION("read - no file") {
+    auto reader = PVDReader("../test/assets/not_existing.pvd");
+    CHECK(!reader.read());
+  }
+
+  SECTION("read - no data set") {
+    auto reader = PVDReader("../test/assets/Result.vtu");
+    CHECK(!reader.read());
+  }
+
+  SECTION("read") {
+    auto reader = PVDReader("../test/assets/Result.pvd");
+    CHECK(reader.read());
+
+    // Sorted by time, relative to the collection
+    const std::vector<PVDDataSet> &dataSets = reader.getDataSets();
+    CHECK(dataSets.size() == 3);
+    CHECK(dataSets.at(0).time == 0);
+    CHECK(dataSets.at(1).time == 0.1);
+    CHECK(dataSets.at(2).time == 0.5);
+    CHECK(dataSets.at(0).file == "../test/assets/Result.vtu");
+  }
+}
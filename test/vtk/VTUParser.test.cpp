@@ -0,0 +1,106 @@
+#include <catch2/catch.hpp>
+
+#include "../../src/vtk/VTUParser.hpp"
+
+/**
+ * Same piece
+ * @param piece Piece
+ * @param reference Reference piece
+ */
+static void checkSamePiece(const VTUParsedPiece &piece,
+                           const VTUParsedPiece &reference) {
+  CHECK(piece.numberOfPoints == reference.numberOfPoints);
+  CHECK(piece.numberOfCells == reference.numberOfCells);
+  CHECK(piece.connectivity == reference.connectivity);
+  CHECK(piece.offsets == reference.offsets);
+  CHECK(piece.types == reference.types);
+
+  REQUIRE(piece.points.size == reference.points.size);
+  for (size_t i = 0; i < piece.points.size; ++i)
+    CHECK(piece.points.at(i) == reference.points.at(i));
+
+  REQUIRE(piece.names == reference.names);
+  for (size_t i = 0; i < piece.values.size(); ++i) {
+    REQUIRE(piece.values.at(i).size == reference.values.at(i).size);
+    for (size_t j = 0; j < piece.values.at(i).size; ++j)
+      CHECK(piece.values.at(i).at(j) == reference.values.at(i).at(j));
+  }
+
+  REQUIRE(piece.cellNames == reference.cellNames);
+  for (size_t i = 0; i < piece.cellValues.size(); ++i) {
+    REQUIRE(piece.cellValues.at(i).size == reference.cellValues.at(i).size);
+    for (size_t j = 0; j < piece.cellValues.at(i).size; ++j)
+      CHECK(piece.cellValues.at(i).at(j) == reference.cellValues.at(i).at(j));
+  }
+}
+
+TEST_CASE("VTUParser") {
+  SECTION("Constructor 1") { auto parser = VTUParser(); }
+
+  SECTION("Constructor 2") { auto parser = VTUParser("filename"); }
+
+  SECTION("read - no file") {
+    auto parser = VTUParser("../test/assets/not_existing.vtu");
+    CHECK(!parser.read());
+  }
+
+  SECTION("read - not supported") {
+    auto parser = VTUParser("../test/assets/ResultPieces.pvtu");
+    CHECK(!parser.read());
+  }
+
+  SECTION("read - corrupt zlib header") {
+    // One block of 12 bytes, declared as 1 TiB once inflated
+    auto parser = VTUParser("../test/assets/ResultZlibCorrupt.vtu");
+    CHECK(!parser.read());
+  }
+
+  SECTION("read - ascii") {
+    auto parser = VTUParser("../test/assets/Result.vtu");
+    CHECK(parser.read());
+
+    const std::vector<VTUParsedPiece> &pieces = parser.getPieces();
+    REQUIRE(pieces.size() == 1);
+    const VTUParsedPiece &piece = pieces.front();
+    CHECK(piece.numberOfPoints == 687);
+    CHECK(piece.numberOfCells == 3545);
+    CHECK(piece.points.floats != nullptr);
+    CHECK(piece.offsets.size() == 3545 + 1);
+    CHECK(piece.offsets.front() == 0);
+    CHECK(piece.names ==
+          std::vector<std::string>({"Displacement", "vonMises"}));
+    CHECK(piece.sizes == std::vector<int>({3, 1}));
+    CHECK(piece.cellNames == std::vector<std::string>({"Label"}));
+    CHECK(piece.cellValues.front().size == 3545);
+  }
+
+  SECTION("read - binary") {
+    auto reference = VTUParser("../test/assets/Result.vtu");
+    REQUIRE(reference.read());
+
+    for (const std::string fileName :
+         {"ResultRaw.vtu", "ResultZlib.vtu", "ResultBase64.vtu",
+          "ResultBinary.vtu"}) {
+      auto parser = VTUParser("../test/assets/" + fileName);
+      REQUIRE(parser.read());
+      REQUIRE(parser.getPieces().size() == 1);
+      checkSamePiece(parser.getPieces().front(),
+                     reference.getPieces().front());
+
+      // Float64, viewed
+      CHECK(parser.getPieces().front().values.front().doubles != nullptr);
+    }
+  }
+
+  SECTION("read - no cell data") {
+    auto parser = VTUParser("../test/assets/ResultZlib.vtu");
+    parser.setCellData(false);
+    CHECK(parser.read());
+
+    const VTUParsedPiece &piece = parser.getPieces().front();
+    CHECK(piece.numberOfPoints == 687);
+    CHECK(piece.points.size == 3 * 687);
+    CHECK(piece.cellNames.empty());
+    CHECK(piece.values.size() == 2);
+  }
+}
@@ -20,6 +20,206 @@ TEST_CASE("VTUReader") {
 
     std::vector<VTUData> arrays = reader.getArrays();
     CHECK(arrays.size() == 2);
+
+    // Float64 arrays, viewed in place
+    CHECK(arrays.at(0).values.doubles != nullptr);
+    CHECK(arrays.at(0).values.floats == nullptr);
+    CHECK(arrays.at(0).values.size == reader.getGeometry()->vertices.size() *
+                                          arrays.at(0).size);
+
+    // One geometry, shared by all arrays & results
+    CHECK(arrays.at(0).geometry == reader.getGeometry());
+    CHECK(arrays.at(1).geometry == reader.getGeometry());
+
+    std::vector<Result> results = reader.getResults();
+    CHECK(results.size() == 2);
+    CHECK(results.at(0).geometry == results.at(1).geometry);
+    CHECK(results.at(0).trianglesValues.size() ==
+          results.at(0).geometry->trianglesIds.size() * results.at(0).size);
+  }
+
+  SECTION("read cell data - average") {
+    auto reader = VTUReader("../test/assets/Result.vtu");
+    reader.setCellData(CellDataMode::Average);
+    CHECK(reader.read());
+
+    // Label, averaged at the points
+    std::vector<VTUData> arrays = reader.getArrays();
+    CHECK(arrays.size() == 3);
+    CHECK(arrays.at(2).name == "Label");
+    CHECK(!arrays.at(2).cell);
+    CHECK(arrays.at(2).values.size == reader.getGeometry()->vertices.size());
+
+    std::vector<Result> results = reader.getResults();
+    CHECK(results.at(2).geometry->trianglesVertices.size() == 486);
+  }
+
+  SECTION("read cell data - flat") {
+    auto reader = VTUReader("../test/assets/Result.vtu");
+    reader.setCellData(CellDataMode::Flat);
+    CHECK(reader.read());
+
+    std::vector<VTUData> arrays = reader.getArrays();
+    CHECK(arrays.size() == 3);
+    CHECK(arrays.at(2).cell);
+
+    // Vertices split between labels
+    std::vector<Result> results = reader.getResults();
+    const ResultGeometry &geometry = *results.at(2).geometry;
+    CHECK(geometry.triangles.size() == 968);
+    CHECK(geometry.trianglesVertices.size() == 586);
+    CHECK(results.at(2).trianglesValues.size() == 586);
+    CHECK(results.at(2).trianglesMinValue == 1);
+    CHECK(results.at(2).trianglesMaxValue == 6);
+
+    // Point data on the same split vertices
+    CHECK(results.at(0).trianglesValues.size() == 586 * 3);
+  }
+
+  SECTION("read - native") {
+    for (const std::string fileName :
+         {"ResultRaw.vtu", "ResultZlib.vtu", "ResultBase64.vtu",
+          "ResultBinary.vtu"}) {
+      auto reader = VTUReader("../test/assets/" + fileName);
+      reader.setNative(true);
+      reader.setCellData(CellDataMode::Flat);
+      CHECK(reader.read());
+
+      std::vector<VTUData> arrays = reader.getArrays();
+      CHECK(arrays.size() == 3);
+      CHECK(reader.getGeometry()->vertices.size() == 687);
+      CHECK(reader.getGeometry()->triangles.size() == 968);
+
+      std::vector<Result> results = reader.getResults();
+      CHECK(results.at(2).geometry->trianglesVertices.size() == 586);
+      CHECK(results.at(0).trianglesValues.size() == 586 * 3);
+    }
+  }
+
+  SECTION("read - reused geometry") {
+    auto first = VTUReader("../test/assets/Result.vtu");
+    CHECK(first.read());
+    std::shared_ptr<const ResultGeometry> geometry =
+        first.getResultGeometry();
+
+    // Only the fields are read
+    auto next = VTUReader("../test/assets/Result.vtu");
+    next.setGeometry(first.getGeometry());
+    CHECK(next.read());
+    CHECK(next.getGeometry() == first.getGeometry());
+
+    std::vector<Result> results = next.getResults(geometry);
+    CHECK(results.size() == 2);
+    CHECK(results.at(0).geometry == geometry);
+    CHECK(results.at(0).trianglesValues ==
+          first.getResults().at(0).trianglesValues);
+
+    // Different mesh
+    auto other = VTUReader("../test/assets/Result2Pieces.vtu");
+    other.setGeometry(first.getGeometry());
+    CHECK(!other.read());
+
+    // Same mesh, natively parsed
+    auto native = VTUReader("../test/assets/Result.vtu");
+    native.setNative(true);
+    CHECK(native.read());
+
+    auto zlib = VTUReader("../test/assets/ResultZlib.vtu");
+    zlib.setNative(true);
+    zlib.setGeometry(native.getGeometry());
+    CHECK(zlib.read());
+
+    // Moved mesh, same counts
+    auto moved = VTUReader("../test/assets/ResultMoved.vtu");
+    moved.setNative(true);
+    moved.setGeometry(native.getGeometry());
+    CHECK(!moved.read());
+  }
+
+  SECTION("read polylines") {
+    auto reader = VTUReader("../test/assets/Result_streamTracer.vtu");
+    reader.setNative(true);
+    CHECK(reader.read());
+
+    const Polylines &polylines = reader.getGeometry()->polygons;
+    CHECK(polylines.size() == 102);
+    CHECK(polylines.getIndices().size() == 967);
+
+    std::vector<Result> results = reader.getResults();
+    const Polylines &resultPolylines = results.at(0).geometry->polygons;
+    CHECK(resultPolylines.size() == 102);
+    CHECK(resultPolylines.getOffsets() == polylines.getOffsets());
+
+    // Streamlines not joined
+    CHECK(resultPolylines.getSegments().size() == 2 * (967 - 102));
+  }
+
+  SECTION("read vertices") {
+    auto reader = VTUReader("../test/assets/ResultVertices.vtu");
+    reader.setNative(true);
+    CHECK(reader.read());
+
+    // Vertex cells, no segment
+    std::vector<Result> results = reader.getResults();
+    CHECK(results.size() == 1);
+    const Polylines &polylines = results.at(0).geometry->polygons;
+    CHECK(polylines.size() == 4);
+    CHECK(polylines.getIndices().size() == 4);
+    CHECK(polylines.getSegments().empty());
+    CHECK(results.at(0).polygonsValues.size() == 4);
+  }
+
+  SECTION("read vertex & line") {
+    auto reader = VTUReader("../test/assets/ResultVertexLine.vtu");
+    reader.setNative(true);
+    CHECK(reader.read());
+
+    // One segment & one point, neither dropped
+    std::vector<Result> results = reader.getResults();
+    const Polylines &polylines = results.at(0).geometry->polygons;
+    CHECK(polylines.size() == 2);
+    CHECK(polylines.getSegments().size() == 2);
+    CHECK(polylines.getPoints().size() == 1);
+  }
+
+  SECTION("read cell types") {
+    // Quad, pentagon, hexahedron & line
+    auto reader = VTUReader("../test/assets/ResultCells.vtu");
+    reader.setNative(true);
+    reader.setCellData(CellDataMode::Flat);
+    CHECK(reader.read());
+
+    // Quad & pentagon triangulated, hexahedron skipped
+    const VTUGeometry &geometry = *reader.getGeometry();
+    CHECK(geometry.numberOfCells == 4);
+    CHECK(geometry.triangles.size() == 2 + 3);
+    CHECK(geometry.triangles.at(1).Label() == 0);
+    CHECK(geometry.triangles.at(2).Label() == 1);
+    CHECK(geometry.tetrahedra.empty());
+    CHECK(geometry.polygons.size() == 1);
+    CHECK(geometry.polygonsCells == std::vector<uint>({3}));
+
+    // One label per cell
+    std::vector<Result> results = reader.getResults();
+    CHECK(results.at(1).trianglesMinValue == 1);
+    CHECK(results.at(1).trianglesMaxValue == 2);
+  }
+
+  SECTION("read volume") {
+    // Result.vtu without its triangles
+    auto reader = VTUReader("../test/assets/ResultVolume.vtu");
+    CHECK(reader.read());
+    CHECK(reader.getGeometry()->triangles.empty());
+
+    std::vector<Result> results = reader.getResults();
+    CHECK(results.size() == 2);
+
+    // Boundary of the tetrahedra
+    const ResultGeometry &geometry = *results.at(0).geometry;
+    CHECK(geometry.triangles.size() == 968);
+    CHECK(geometry.trianglesVertices.size() == 486);
+    CHECK(results.at(0).trianglesValues.size() == 486 * 3);
+    CHECK(results.at(1).trianglesValues.size() == 486);
   }
 
   SECTION("read 2 pieces") {
@@ -28,5 +228,51 @@ TEST_CASE("VTUReader") {
 
     std::vector<VTUData> arrays = reader.getArrays();
     CHECK(arrays.size() == 1);
+
+    // Both pieces are the same, welded
+    CHECK(reader.getGeometry()->vertices.size() == 167);
+    CHECK(reader.getGeometry()->triangles.size() == 2 * 330);
+    CHECK(reader.getGeometry()->trianglesPieces.empty());
+    CHECK(arrays.at(0).values.size == 167);
+  }
+
+  SECTION("read 2 pieces - duplicates inside a piece") {
+    auto reader = VTUReader("../test/assets/Result2PiecesCrack.vtu");
+    reader.setNative(true);
+    CHECK(reader.read());
+
+    // Crack vertices 1 & 3 of the first piece kept apart, the second piece
+    // welded to the first one
+    CHECK(reader.getGeometry()->vertices.size() == 6);
+    CHECK(reader.getGeometry()->remaps ==
+          std::vector<std::vector<uint>>({{0, 1, 2, 3, 4}, {1, 5, 4}}));
+
+    // Values of both crack vertices kept
+    std::vector<VTUData> arrays = reader.getArrays();
+    CHECK(arrays.at(0).values.size == 6);
+    CHECK(arrays.at(0).values.at(3) == 3);
+  }
+
+  SECTION("read pvtu") {
+    auto reader = VTUReader("../test/assets/ResultPieces.pvtu");
+    CHECK(reader.read());
+
+    std::vector<VTUData> arrays = reader.getArrays();
+    CHECK(arrays.size() == 1);
+    CHECK(reader.getGeometry()->vertices.size() == 167);
+  }
+
+  SECTION("read 2 pieces - not welded") {
+    auto reader = VTUReader("../test/assets/Result2Pieces.vtu");
+    reader.setWeld(false);
+    reader.read();
+
+    CHECK(reader.getGeometry()->vertices.size() == 2 * 167);
+    CHECK(reader.getGeometry()->trianglesPieces ==
+          std::vector<size_t>({0, 330, 660}));
+
+    std::vector<Result> results = reader.getResults();
+    CHECK(results.at(0).geometry->trianglesPieces ==
+          reader.getGeometry()->trianglesPieces);
   }
 }
\ No newline at end of file